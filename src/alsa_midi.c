@@ -42,6 +42,7 @@
 #include "midi_menu.h"
 #include "alsa_midi.h"
 #include "message.h"
+#include "rtsched.h"
 
 #ifndef __APPLE__
 
@@ -91,6 +92,7 @@ static void *midi_thread(void *arg) {
   unsigned short revents;
   int i;
   int chan = 0, arg1 = 0, arg2;
+  rtsched_default();
   npfds = snd_rawmidi_poll_descriptors_count(input);
   // replaced alloca by variable-length array
   struct pollfd pfds[npfds];
@@ -58,6 +58,7 @@ static const int cw_high_water = 1152;                // high water mark for CW
 #include "mode.h"
 #include "vfo.h"
 #include "message.h"
+#include "rtsched.h"
 
 int audio = 0;
 GMutex audio_mutex;
@@ -628,6 +629,7 @@ static void *mic_read_thread(gpointer arg) {
   int16_t *short_buffer;
   float sample;
   int i;
+  rtsched_default();
   t_print("%s: mic_buffer_size=%d\n", __FUNCTION__, mic_buffer_size);
   t_print("%s: snd_pcm_start\n", __FUNCTION__);
 
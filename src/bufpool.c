@@ -0,0 +1,120 @@
+/* Copyright (C)
+* 2026 - the piHPSDR authors
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*
+*/
+
+#include <gtk/gtk.h>
+#include <stdlib.h>
+
+#include "bufpool.h"
+#include "message.h"
+
+//
+// Push a buffer onto the free stack. May be called from any thread.
+//
+static void bufpool_push(BUFPOOL *pool, mybuffer *buf) {
+  int old;
+
+  do {
+    old = g_atomic_int_get(&pool->head);
+    g_atomic_int_set(&buf->next, old);
+  } while (!g_atomic_int_compare_and_exchange(&pool->head, old, buf->index));
+
+  g_atomic_int_add(&pool->in_use, -1);
+}
+
+//
+// Allocate a pool of "size" buffers, all of them free.
+// The pool is never released to the operating system.
+//
+BUFPOOL *bufpool_create(const char *name, int size) {
+  BUFPOOL *pool = g_new0(BUFPOOL, 1);
+  pool->name = name;
+  pool->size = size;
+
+  if (posix_memalign((void **) &pool->buffers, 64, size * sizeof(mybuffer)) != 0) {
+    t_print("%s: could not allocate %d buffers for pool %s\n", __FUNCTION__, size, name);
+    exit(-1);
+  }
+
+  for (int i = 0; i < size; i++) {
+    mybuffer *buf = &pool->buffers[i];
+    buf->pool = pool;
+    buf->index = i;
+    buf->free = 1;
+    buf->next = i + 1 < size ? i + 1 : -1;
+  }
+
+  pool->head = 0;
+  t_print("%s: pool %s with %d buffers\n", __FUNCTION__, name, size);
+  return pool;
+}
+
+//
+// Obtain a free buffer in constant time, or NULL if the pool is exhausted.
+// Must only be called from a single thread per pool (see bufpool.h).
+//
+mybuffer *bufpool_get(BUFPOOL *pool) {
+  int top;
+  mybuffer *buf;
+
+  do {
+    top = g_atomic_int_get(&pool->head);
+
+    if (top < 0) {
+      pool->exhausted++;
+
+      if (pool->exhausted == 1 || (pool->exhausted % 1000) == 0) {
+        t_print("%s: pool %s exhausted (%d times)\n", __FUNCTION__, pool->name, pool->exhausted);
+      }
+
+      return NULL;
+    }
+
+    buf = &pool->buffers[top];
+  } while (!g_atomic_int_compare_and_exchange(&pool->head, top, g_atomic_int_get(&buf->next)));
+
+  g_atomic_int_set(&buf->free, 0);
+  int used = g_atomic_int_add(&pool->in_use, 1) + 1;
+
+  if (used > pool->high_water) { pool->high_water = used; }
+
+  return buf;
+}
+
+//
+// Return a buffer to its pool. Releasing a buffer that is
+// already free (e.g. after bufpool_release_all) does nothing.
+//
+void mybuffer_release(mybuffer *buf) {
+  if (g_atomic_int_compare_and_exchange(&buf->free, 0, 1)) {
+    bufpool_push(buf->pool, buf);
+  }
+}
+
+//
+// Upon a protocol restart, reclaim all buffers that are still in use.
+//
+void bufpool_release_all(BUFPOOL *pool) {
+  for (int i = 0; i < pool->size; i++) {
+    mybuffer_release(&pool->buffers[i]);
+  }
+}
+
+void bufpool_stats(const BUFPOOL *pool) {
+  t_print("%s: pool %s: size=%d in_use=%d high_water=%d exhausted=%d\n", __FUNCTION__,
+          pool->name, pool->size, g_atomic_int_get(&pool->in_use), pool->high_water, pool->exhausted);
+}
@@ -0,0 +1,86 @@
+/* Copyright (C)
+* 2026 - the piHPSDR authors
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*
+*/
+
+#ifndef _BUFPOOL_H_
+#define _BUFPOOL_H_
+
+// Network buffers
+// Maximum length is 1444
+
+#define NET_BUFFER_SIZE  1500
+
+/////////////////////////////////////////////////////////////////////////////
+//
+// PEDESTRIAN BUFFER MANAGEMENT
+//
+////////////////////////////////////////////////////////////////////////////
+//
+// A pool of network buffers is allocated *once* and the free
+// buffers are kept on a lock-free stack (linked by index),
+// so obtaining a buffer is O(1) no matter how many buffers
+// are in flight.
+//
+// Buffers may be released from any thread (the IQ, mic and
+// high-priority consumer threads), but a given pool must only
+// be drawn from by a single thread (the one receiving the data).
+// With a single "popper" the stack cannot suffer from the ABA
+// problem, so a plain 32-bit compare-and-swap on the head suffices.
+//
+// The "free" flag is kept: consumers use it to detect buffers that
+// were reclaimed by a protocol restart while still queued, and
+// releasing a buffer twice is harmless.
+//
+// The fences can be used to detect over-writing
+// (feature currently not used).
+//
+////////////////////////////////////////////////////////////////////////////
+
+typedef struct _bufpool BUFPOOL;
+
+struct mybuffer_ {
+  BUFPOOL         *pool;           // the pool this buffer belongs to
+  int             index;           // position within the pool
+  volatile int    next;            // next free buffer (stack link)
+  volatile int    free;
+  long            lowfence;
+  unsigned char   buffer[NET_BUFFER_SIZE];
+  long            highfence;
+} __attribute__((aligned(64)));
+
+typedef struct mybuffer_ mybuffer;
+
+struct _bufpool {
+  const char      *name;
+  int             size;            // number of buffers
+  mybuffer        *buffers;
+  volatile int    head;            // top of free stack, -1 if empty
+  //
+  // statistics
+  //
+  volatile int    in_use;
+  int             high_water;
+  int             exhausted;
+};
+
+extern BUFPOOL *bufpool_create(const char *name, int size);
+extern mybuffer *bufpool_get(BUFPOOL *pool);
+extern void mybuffer_release(mybuffer *buf);
+extern void bufpool_release_all(BUFPOOL *pool);
+extern void bufpool_stats(const BUFPOOL *pool);
+
+#endif
@@ -53,6 +53,7 @@
 #include "sliders.h"
 #include "message.h"
 #include "mystring.h"
+#include "rtsched.h"
 
 #define DISCOVERY_PORT 4992
 #define LISTEN_PORT 50000
@@ -397,6 +398,7 @@ void send_vfo_data(const REMOTE_CLIENT *client, int v) {
 static void *server_client_thread(void *arg) {
   REMOTE_CLIENT *client = (REMOTE_CLIENT *)arg;
   HEADER header;
+  rtsched_default();
   t_print("Client connected on port %d\n", client->address.sin_port);
   send_radio_data(client);
   send_adc_data(client, 0);
@@ -1901,6 +1903,7 @@ void send_mute_rx(int s, int mute) {
 static void *listen_thread(void *arg) {
   struct sockaddr_in address;
   int on = 1;
+  rtsched_default();
   t_print("hpsdr_server: listening on port %d\n", listen_port);
 
   while (running) {
@@ -2018,6 +2021,7 @@ static void *client_thread(void* arg) {
   int bytes_read;
   HEADER header;
   char *server = (char *)arg;
+  rtsched_default();
   running = TRUE;
 
   while (running) {
@@ -197,6 +197,7 @@
 #include "mode.h"
 #include "vfo.h"
 #include "message.h"
+#include "rtsched.h"
 
 static void* keyer_thread(void *arg);
 static pthread_t keyer_thread_id;
@@ -323,6 +324,7 @@ static void* keyer_thread(void *arg) {
   int moxbefore;
   int cwvox;
   t_print("keyer_thread  state running= %d\n", running);
+  rtsched_apply(THREAD_ROLE_TX);
 
   while (running) {
     enforce_cw_vox = 0;
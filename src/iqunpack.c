@@ -0,0 +1,131 @@
+/* Copyright (C)
+* 2026 - the piHPSDR authors
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*
+*/
+
+//
+// The byte shuffling is done with SIMD instructions if the compiler
+// targets them (on x86 this requires e.g. CFLAGS=-march=native, on
+// 64-bit ARM NEON is always there). The int -> float/double conversion
+// is a simple loop that the compiler vectorizes by itself.
+//
+// Note the SIMD loops never read beyond the last byte of the input.
+//
+
+#if defined(__AVX2__)
+  #include <immintrin.h>
+#elif defined(__SSSE3__)
+  #include <tmmintrin.h>
+#elif defined(__ARM_NEON)
+  #include <arm_neon.h>
+#endif
+
+#include "iqunpack.h"
+
+//
+// Number of values converted "in one go" for the float/double variants
+//
+#define IQ24_CHUNK 256
+
+void iq24_unpack_int(const unsigned char *src, int32_t *dst, int n) {
+  int i = 0;
+#if defined(__AVX2__) || defined(__SSSE3__)
+  //
+  // Move the three bytes of each value to the upper three bytes of
+  // a 32-bit lane (in reversed order, since x86 is little-endian),
+  // then an arithmetic right shift sign-extends the result.
+  //
+  const __m128i shuf = _mm_setr_epi8(-1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9);
+#if defined(__AVX2__)
+  const __m256i shuf2 = _mm256_broadcastsi128_si256(shuf);
+
+  // 8 values (24 bytes) per step, but the second load reads 28 bytes
+  for (; i + 10 <= n; i += 8) {
+    const unsigned char *p = src + 3 * i;
+    __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) p)),
+                                        _mm_loadu_si128((const __m128i *)(p + 12)), 1);
+    _mm256_storeu_si256((__m256i *)(dst + i), _mm256_srai_epi32(_mm256_shuffle_epi8(v, shuf2), 8));
+  }
+
+#endif
+
+  // 4 values (12 bytes) per step, but the load reads 16 bytes
+  for (; i + 6 <= n; i += 4) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(src + 3 * i));
+    _mm_storeu_si128((__m128i *)(dst + i), _mm_srai_epi32(_mm_shuffle_epi8(v, shuf), 8));
+  }
+
+#elif defined(__ARM_NEON)
+
+  //
+  // vld3 de-interleaves the high, middle and low bytes of 8 values
+  //
+  for (; i + 8 <= n; i += 8) {
+    uint8x8x3_t b = vld3_u8(src + 3 * i);
+    uint16x8_t hi = vorrq_u16(vshll_n_u8(b.val[0], 8), vmovl_u8(b.val[1]));
+    uint16x8_t lo = vshll_n_u8(b.val[2], 8);
+    uint32x4_t w0 = vorrq_u32(vshll_n_u16(vget_low_u16(hi), 16), vmovl_u16(vget_low_u16(lo)));
+    uint32x4_t w1 = vorrq_u32(vshll_n_u16(vget_high_u16(hi), 16), vmovl_u16(vget_high_u16(lo)));
+    vst1q_s32(dst + i, vshrq_n_s32(vreinterpretq_s32_u32(w0), 8));
+    vst1q_s32(dst + i + 4, vshrq_n_s32(vreinterpretq_s32_u32(w1), 8));
+  }
+
+#endif
+
+  for (; i < n; i++) {
+    const unsigned char *p = src + 3 * i;
+    int32_t sample;
+    sample  = (int)((signed char) p[0]) << 16;
+    sample |= (int)((((unsigned char)p[1]) << 8) & 0xFF00);
+    sample |= (int)((unsigned char)p[2] & 0xFF);
+    dst[i] = sample;
+  }
+}
+
+void iq24_unpack_float(const unsigned char *src, float *dst, int n) {
+  int32_t tmp[IQ24_CHUNK];
+
+  while (n > 0) {
+    int m = n < IQ24_CHUNK ? n : IQ24_CHUNK;
+    iq24_unpack_int(src, tmp, m);
+
+    // The "obscure" constant 1.1920928955078125E-7 is 1/(2^23)
+    for (int i = 0; i < m; i++) {
+      dst[i] = (float) tmp[i] * 1.1920928955078125E-7F;
+    }
+
+    src += 3 * m;
+    dst += m;
+    n -= m;
+  }
+}
+
+void iq24_unpack_double(const unsigned char *src, double *dst, int n) {
+  int32_t tmp[IQ24_CHUNK];
+
+  while (n > 0) {
+    int m = n < IQ24_CHUNK ? n : IQ24_CHUNK;
+    iq24_unpack_int(src, tmp, m);
+
+    for (int i = 0; i < m; i++) {
+      dst[i] = (double) tmp[i] * 1.1920928955078125E-7;
+    }
+
+    src += 3 * m;
+    dst += m;
+    n -= m;
+  }
+}
@@ -0,0 +1,42 @@
+/* Copyright (C)
+* 2026 - the piHPSDR authors
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*
+*/
+
+//
+// Conversion of 24-bit big-endian (signed) samples, as they are used
+// for I/Q data in HPSDR packets, into contiguous int/float/double arrays.
+//
+// "n" is the number of 24-bit values (that is, twice the number of
+// I/Q samples), the order of the values is preserved, so interleaved
+// I/Q data stays interleaved. The float and double variants scale the
+// values by 1/2^23, such that the results are in the range [-1.0, 1.0).
+// All variants give bit-identical results, no matter whether a SIMD
+// (SSSE3/AVX2, NEON) or the scalar code is used.
+//
+// This file does not depend on GTK and is also linked into hpsdrsim.
+//
+
+#ifndef _IQUNPACK_H_
+#define _IQUNPACK_H_
+
+#include <stdint.h>
+
+extern void iq24_unpack_int(const unsigned char *src, int32_t *dst, int n);
+extern void iq24_unpack_float(const unsigned char *src, float *dst, int n);
+extern void iq24_unpack_double(const unsigned char *src, double *dst, int n);
+
+#endif
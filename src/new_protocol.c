@@ -16,6 +16,10 @@
 *
 */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+  #define _GNU_SOURCE  // for recvmmsg()
+#endif
+
 #include <gtk/gtk.h>
 #include <errno.h>
 #include <stdio.h>
@@ -62,8 +66,11 @@
 #include "vox.h"
 #include "ext.h"
 #include "iambic.h"
+#include "iqunpack.h"
 #include "rigctl.h"
 #include "message.h"
+#include "rtsched.h"
+#include "seqstat.h"
 #ifdef SATURN
   #include "saturnmain.h"
 #endif
@@ -120,6 +127,23 @@ static int iq_addr_length;
 static struct sockaddr_in data_addr[MAX_DDC];
 static int data_addr_length[MAX_DDC];
 
+//
+// Optional per-DDC sockets (p2_ddc_sockets, see open_ddc_sockets())
+//
+static int ddc_socket[MAX_DDC] = { -1, -1, -1, -1 };
+static long long ddc_recv_calls[MAX_DDC];    // number of receive system calls
+static long long ddc_recv_packets[MAX_DDC];  // number of datagrams received
+static long long ddc_recv_short[MAX_DDC];    // number of datagrams too short for their sample count
+
+//
+// DDC timing telemetry (see new_protocol.h). For each DDC, the data is
+// only updated by the thread that receives the packets, ddc_rate is
+// set in new_protocol_receive_specific().
+//
+static P2_DDC_TIMING ddc_timing[MAX_DDC];
+static volatile int ddc_rate[MAX_DDC];
+static volatile int ddc_timing_reset[MAX_DDC];
+
 static GThread *new_protocol_thread_id;
 static GThread *new_protocol_rxaudio_thread_id;
 static GThread *new_protocol_txiq_thread_id;
@@ -129,12 +153,15 @@ static unsigned long high_priority_sequence = 0;
 static unsigned long general_sequence = 0;
 static unsigned long rx_specific_sequence = 0;
 static unsigned long tx_specific_sequence = 0;
-static unsigned long ddc_sequence[MAX_DDC];
 
 static unsigned long tx_iq_sequence = 0;
 
-static unsigned long highprio_rcvd_sequence = 0;
-static unsigned long micsamples_sequence = 0;
+//
+// Sequence and loss accounting for the streams from the radio (see seqstat.h)
+//
+static SEQSTAT ddc_seqstat[MAX_DDC];
+static SEQSTAT hp_seqstat;
+static SEQSTAT mic_seqstat;
 
 #ifdef __APPLE__
   static sem_t *high_priority_sem_ready;
@@ -203,38 +230,16 @@ static volatile int rxaudio_flag      = 0;  // 0: RX, 1: TX
 
 static pthread_mutex_t send_rxaudio_mutex   = PTHREAD_MUTEX_INITIALIZER;
 
-/////////////////////////////////////////////////////////////////////////////
-//
-// PEDESTRIAN BUFFER MANAGEMENT
-//
-////////////////////////////////////////////////////////////////////////////
-//
-// Instead of allocating and free-ing (malloc/free) the network buffers
-// at a very high rate, we do it the "pedestrian" way, which may
-// alleviate the system load a little.
-//
-// Therefore we allocate a pool of network buffers *once*, make
-// them a linked list, and simply maintain a "free" flag.
-//
-// This ONLY applies to the network buffers filled with data in
-// new_protocol_thread(), so this need not be thread-safe.
-//
-////////////////////////////////////////////////////////////////////////////
-
-//
-// number of buffers allocated (for statistics)
-//
-static int num_buf = 0;
-
 //
-// head of buffer list
+// Pool of network buffers filled with data in new_protocol_thread()
+// (see bufpool.h). It is allocated once, and sized such that it
+// cannot run dry as long as the ring buffers below do not overflow.
 //
-static mybuffer *buflist = NULL;
+static BUFPOOL *net_pool = NULL;
 
 //
 // The buffers used by new_protocol_thread
 //
-#define RXIQRINGBUFLEN 512
 static volatile mybuffer *iq_buffer[MAX_DDC][RXIQRINGBUFLEN];
 static volatile int iq_inptr[MAX_DDC] = { 0 };
 static volatile int iq_outptr[MAX_DDC] = { 0 };
@@ -242,7 +247,6 @@ static volatile int iq_count[MAX_DDC] = { 0 };
 
 static mybuffer *high_priority_buffer;
 
-#define MICRINGBUFLEN 64
 static volatile mybuffer *mic_line_buffer[MICRINGBUFLEN];
 static volatile int mic_inptr = 0;
 static volatile int mic_outptr = 0;
@@ -280,49 +284,14 @@ static gpointer new_protocol_timer_thread(gpointer data);
 static gpointer high_priority_thread(gpointer data);
 static gpointer mic_line_thread(gpointer data);
 static gpointer iq_thread(gpointer data);
+static void open_ddc_sockets(void);
+static int iq_samples_per_frame(const unsigned char *buffer);
 static void  process_iq_data(const unsigned char *buffer, RECEIVER *rx);
 static void  process_ps_iq_data(const unsigned char *buffer);
 static void process_div_iq_data(const unsigned char *buffer);
 static void  process_high_priority(void);
 static void  process_mic_data(const unsigned char *buffer);
 
-//
-// Obtain a free buffer. If no one is available allocate
-// 5 new ones. The buffers are *never* released to the
-// operating system, but marked free upon a protocol restart.
-//
-static mybuffer *get_my_buffer() {
-  int i;
-  mybuffer *bp = buflist;
-
-  while (bp) {
-    if (bp->free) {
-      // found free buffer. Mark as used and return that one.
-      bp->free = 0;
-      return bp;
-    }
-
-    bp = bp->next;
-  }
-
-  //
-  // no free buffer found, allocate some extra ones
-  // and add to the head of the list
-  //
-  for (i = 0; i < 25; i++) {
-    bp = malloc(sizeof(mybuffer));
-    bp->free = 1;
-    bp->next = buflist;
-    buflist = bp;
-    num_buf++;
-  }
-
-  t_print("NewProtocol: number of buffers increased to %d\n", num_buf);
-  // Mark the first buffer in list as used and return that one.
-  buflist->free = 0;
-  return buflist;
-}
-
 void schedule_high_priority() {
   if (protocol == NEW_PROTOCOL) {
     new_protocol_high_priority();
@@ -479,7 +448,7 @@ void new_protocol_init() {
 
   //
   // Initialize semaphores for the never-finishing threads
-  // (HighPrio, Mic, rxIQ) and spawn these threads.
+  // (HighPrio, Mic, rxIQ). The threads are spawned further down.
   //
 #ifdef __APPLE__
   high_priority_sem_ready = apple_sem(0);
@@ -501,15 +470,16 @@ void new_protocol_init() {
 
 #endif
 
-  high_priority_thread_id = g_thread_new( "P2 HP", high_priority_thread, NULL);
-  mic_line_thread_id = g_thread_new( "P2 MIC", mic_line_thread, NULL);
-
   for (i = 0; i < MAX_DDC; i++) {
-    char text[16];
-    snprintf(text, 16, "P2 DDC%d", i);
-    iq_thread_id[i] = g_thread_new(text, iq_thread, GINT_TO_POINTER(i));
+    char name[16];
+    snprintf(name, sizeof(name), "P2 DDC%d", i);
+    seqstat_register(&ddc_seqstat[i], name);
   }
 
+  seqstat_register(&hp_seqstat, "P2 HighPrio");
+  seqstat_register(&mic_seqstat, "P2 Mic");
+  seqstat_register_dump(new_protocol_ddc_timing_print);
+
   //
   // Setup communication (this is also done *once*)
   // In XDMA mode, just call saturn_init(), in network mode, establish
@@ -636,6 +606,23 @@ void new_protocol_init() {
       data_addr_length[i] = radio->info.network.address_length;
       data_addr[i].sin_port = htons(RX_IQ_TO_HOST_PORT_0 + i);
     }
+
+    if (p2_ddc_sockets) {
+      open_ddc_sockets();
+    }
+  }
+
+  //
+  // The IQ threads must be spawned after the DDC sockets have been
+  // opened, since they decide upon start-up where to get their data from.
+  //
+  high_priority_thread_id = g_thread_new( "P2 HP", high_priority_thread, NULL);
+  mic_line_thread_id = g_thread_new( "P2 MIC", mic_line_thread, NULL);
+
+  for (i = 0; i < MAX_DDC; i++) {
+    char text[16];
+    snprintf(text, 16, "P2 DDC%d", i);
+    iq_thread_id[i] = g_thread_new(text, iq_thread, GINT_TO_POINTER(i));
   }
 
   //
@@ -645,6 +632,79 @@ void new_protocol_init() {
   new_protocol_menu_start();
 }
 
+//
+// Optional per-DDC sockets.
+// Normally, all packets from the radio arrive at data_socket and are
+// de-multiplexed in new_protocol_thread, such that a single thread
+// handles all DDC traffic. If p2_ddc_sockets is set, we open one more
+// socket per DDC that is bound to the same local address and port
+// (SO_REUSEPORT) and connected to the DDC's source port on the radio.
+// The kernel then delivers the packets of that DDC to the connected
+// socket (best match), and each IQ thread reads its own DDC directly.
+// Packets from other ports (HighPrio, Mic, DDCs beyond MAX_DDC) still
+// arrive at data_socket.
+//
+// If anything goes wrong, we silently fall back to data_socket only.
+//
+#if defined(__linux__) && defined(MSG_WAITFORONE)
+  #define HAVE_RECVMMSG
+#endif
+
+static void open_ddc_sockets() {
+#ifdef SO_REUSEPORT
+  struct sockaddr_in local;
+  socklen_t local_length = sizeof(local);
+
+  if (getsockname(data_socket, (struct sockaddr *)&local, &local_length) < 0) {
+    t_perror("NewProtocol: getsockname data_socket:");
+    return;
+  }
+
+  for (int i = 0; i < MAX_DDC; i++) {
+    int optval = 1;
+    int sock = socket(PF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+    if (sock < 0) {
+      t_perror("NewProtocol: create DDC socket:");
+      break;
+    }
+
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, (char *)&optval, sizeof(optval));
+    setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, (char *)&optval, sizeof(optval));
+    optval = 0x40000;
+
+    if (setsockopt(sock, SOL_SOCKET, SO_RCVBUF, (char *)&optval, sizeof(optval)) < 0) {
+      t_perror("DDC socket: set SO_RCVBUF");
+    }
+
+    if (bind(sock, (struct sockaddr *)&local, local_length) < 0
+        || connect(sock, (struct sockaddr *)&data_addr[i], data_addr_length[i]) < 0) {
+      t_perror("NewProtocol: bind/connect DDC socket:");
+      close(sock);
+      break;
+    }
+
+    ddc_socket[i] = sock;
+  }
+
+  if (ddc_socket[MAX_DDC - 1] < 0) {
+    for (int i = 0; i < MAX_DDC; i++) {
+      if (ddc_socket[i] >= 0) {
+        close(ddc_socket[i]);
+        ddc_socket[i] = -1;
+      }
+    }
+
+    t_print("%s: per-DDC sockets not available, using data_socket only\n", __FUNCTION__);
+    return;
+  }
+
+  t_print("%s: per-DDC sockets bound to %s:%d\n", __FUNCTION__, inet_ntoa(local.sin_addr), ntohs(local.sin_port));
+#else
+  t_print("%s: SO_REUSEPORT not available, using data_socket only\n", __FUNCTION__);
+#endif
+}
+
 static void new_protocol_general() {
   const BAND *band;
   int rc;
@@ -1628,6 +1688,10 @@ static void new_protocol_receive_specific() {
     receive_specific_buffer[7] = 1;                                                // enable  DDC0 but disable all others
   }
 
+  for (i = 0; i < MAX_DDC; i++) {
+    ddc_rate[i] = 1000 * ((receive_specific_buffer[18 + (i * 6)] << 8) + receive_specific_buffer[19 + (i * 6)]);
+  }
+
   //t_print("new_protocol_receive_specific: %s:%d enable=%02X\n",inet_ntoa(receiver_addr.sin_addr),ntohs(receiver_addr.sin_port),receive_specific_buffer[7]);
 
   if (have_saturn_xdma) {
@@ -1686,9 +1750,29 @@ void new_protocol_menu_stop() {
 
   if (!have_saturn_xdma) {
     g_thread_join(new_protocol_thread_id);
+    bufpool_stats(net_pool);
+
+    for (int i = 0; i < MAX_DDC; i++) {
+      if (ddc_recv_calls[i] > 0) {
+        t_print("%s: DDC%d socket: %lld syscalls, %lld packets, avg batch=%.2f, short=%lld\n", __FUNCTION__, i,
+                ddc_recv_calls[i], ddc_recv_packets[i], (double) ddc_recv_packets[i] / (double) ddc_recv_calls[i],
+                ddc_recv_short[i]);
+      }
+    }
   }
 
   g_thread_join(new_protocol_timer_thread_id);
+
+  new_protocol_ddc_timing_print();
+
+  for (int i = 0; i < MAX_DDC; i++) {
+    if (ddc_seqstat[i].c.received > 0) {
+      SEQSTAT_REPORT report;
+
+      if (seqstat_lookup(ddc_seqstat[i].name, &report) == 0) { seqstat_print(&report); }
+    }
+  }
+
   new_protocol_high_priority();
   // let the FPGA rest a while
   usleep(200000); // 200 ms
@@ -1722,13 +1806,19 @@ void new_protocol_menu_start() {
   high_priority_sequence = 0;
   rx_specific_sequence = 0;
   tx_specific_sequence = 0;
-  highprio_rcvd_sequence = 0;
-  micsamples_sequence = 0;
   audio_sequence = 0;
   tx_iq_sequence = 0;
   memset(rxcase, 0, sizeof(rxcase));
   memset(rxid, 0, sizeof(rxid));
-  memset(ddc_sequence, 0, sizeof(ddc_sequence));
+
+  for (int i = 0; i < MAX_DDC; i++) {
+    ddc_timing_reset[i] = 1;
+    seqstat_resync(&ddc_seqstat[i]);
+  }
+
+  seqstat_resync(&hp_seqstat);
+  seqstat_resync(&mic_seqstat);
+
   update_action_table();
 
   //
@@ -1739,11 +1829,10 @@ void new_protocol_menu_start() {
     saturn_free_buffers();
 #endif
   } else {
-    mybuffer *mybuf = buflist;
-
-    while (mybuf) {
-      mybuf->free = 1;
-      mybuf = mybuf->next;
+    if (net_pool == NULL) {
+      net_pool = bufpool_create("P2 network", NET_BUFFER_POOL_SIZE);
+    } else {
+      bufpool_release_all(net_pool);
     }
   }
 
@@ -1775,6 +1864,7 @@ void new_protocol_menu_start() {
 static gpointer new_protocol_rxaudio_thread(gpointer data) {
   int nptr;
   unsigned char audiobuffer[260];
+  rtsched_apply(THREAD_ROLE_TX);
 
   //
   // Ideally, a RX audio buffer with 64 samples is sent every 1333 usecs.
@@ -1881,6 +1971,7 @@ static gpointer new_protocol_rxaudio_thread(gpointer data) {
 static gpointer new_protocol_txiq_thread(gpointer data) {
   int nptr;
   unsigned char iqbuffer[1444];
+  rtsched_apply(THREAD_ROLE_TX);
 
   //
   // Ideally, a TX IQ buffer with 240 sample is sent every 1250 usecs.
@@ -1969,6 +2060,7 @@ static gpointer new_protocol_txiq_thread(gpointer data) {
 
 static gpointer new_protocol_thread(gpointer data) {
   t_print("new_protocol_thread\n");
+  rtsched_apply(THREAD_ROLE_RX);
 
   //
   // This thread should do as little work as possible and avoid any blocking.
@@ -1982,10 +2074,25 @@ static gpointer new_protocol_thread(gpointer data) {
     short sourceport;
     int bytesread;
     mybuffer *mybuf;
-    unsigned char *buffer;
-    mybuf = get_my_buffer();
-    buffer = mybuf->buffer;
-    bytesread = recvfrom(data_socket, (char*)buffer, NET_BUFFER_SIZE, 0, (struct sockaddr*)&addr, &length);
+    mybuf = bufpool_get(net_pool);
+
+    if (mybuf == NULL) {
+      //
+      // Pool exhausted (only if the consumer threads are stuck):
+      // read the packet into a scratch buffer and drop it.
+      //
+      static unsigned char scratch[NET_BUFFER_SIZE];
+
+      if (recvfrom(data_socket, (char*)scratch, NET_BUFFER_SIZE, 0, (struct sockaddr*)&addr, &length) > 0) {
+        ddc = ntohs(addr.sin_port) - RX_IQ_TO_HOST_PORT_0;
+
+        if (ddc >= 0 && ddc < MAX_DDC) { seqstat_skipped(&ddc_seqstat[ddc], 1); }
+      }
+
+      continue;
+    }
+
+    bytesread = recvfrom(data_socket, (char*)mybuf->buffer, NET_BUFFER_SIZE, 0, (struct sockaddr*)&addr, &length);
 
     if (!P2running) {
       //
@@ -1993,7 +2100,7 @@ static gpointer new_protocol_thread(gpointer data) {
       // we were doing "recvfrom". In this case, we want to let the main
       // thread terminate gracefully, including writing the props files.
       //
-      mybuf->free = 1;
+      mybuffer_release(mybuf);
       break;
     }
 
@@ -2026,7 +2133,7 @@ static gpointer new_protocol_thread(gpointer data) {
       // programmer. But this should be done in a separate
       // program.
       //
-      mybuf->free = 1;
+      mybuffer_release(mybuf);
       break;
 
     case HIGH_PRIORITY_TO_HOST_PORT:
@@ -2039,7 +2146,7 @@ static gpointer new_protocol_thread(gpointer data) {
 
     default:
       t_print("new_protocol_thread: Unknown port %d\n", sourceport);
-      mybuf->free = 1;
+      mybuffer_release(mybuf);
       break;
     }
   }
@@ -2049,6 +2156,7 @@ static gpointer new_protocol_thread(gpointer data) {
 
 static gpointer high_priority_thread(gpointer data) {
   t_print("high_priority_thread\n");
+  rtsched_apply(THREAD_ROLE_RX);
 
   while (1) {
 #ifdef __APPLE__
@@ -2059,7 +2167,7 @@ static gpointer high_priority_thread(gpointer data) {
     sem_wait(&high_priority_sem_buffer);
 #endif
     process_high_priority();
-    high_priority_buffer->free = 1;
+    mybuffer_release(high_priority_buffer);
   }
 
   return NULL;
@@ -2069,6 +2177,7 @@ static gpointer mic_line_thread(gpointer data) {
   t_print("mic_line_thread\n");
   mybuffer *mybuf;
   int nptr;
+  rtsched_apply(THREAD_ROLE_RX);
 
   //
   // Ideally, a mic sample buffer with 64 samples arrives
@@ -2092,7 +2201,7 @@ static gpointer mic_line_thread(gpointer data) {
     if (mybuf->free) { continue; }
 
     process_mic_data(mybuf->buffer);
-    mybuf->free = 1;
+    mybuffer_release(mybuf);
   }
 
   return NULL;
@@ -2121,13 +2230,23 @@ void saturn_post_high_priority(mybuffer *buffer) {
 
 void saturn_post_micaudio(int bytesread, mybuffer *mybuf) {
   if (!P2running) {
-    mybuf->free = 1;
+    mybuffer_release(mybuf);
     return;
   }
 
+  const unsigned char *buffer = mybuf->buffer;
+  uint32_t expected = mic_seqstat.expected;
+  uint32_t sequence = ((buffer[0] & 0xFF) << 24) + ((buffer[1] & 0xFF) << 16) + ((buffer[2] & 0xFF) << 8) + (buffer[3] & 0xFF);
+
+  if (seqstat_packet(&mic_seqstat, sequence) != SEQSTAT_OK) {
+    t_print("MicSample SeqErr Expected=%lu Seen=%lu\n", (unsigned long) expected, (unsigned long) sequence);
+    sequence_errors++;
+  }
+
   if (mic_count < 0) {
     mic_count++;
-    mybuf->free = 1;
+    seqstat_skipped(&mic_seqstat, 1);
+    mybuffer_release(mybuf);
     return;
   }
 
@@ -2146,43 +2265,172 @@ void saturn_post_micaudio(int bytesread, mybuffer *mybuf) {
     mic_inptr = nptr;
   } else {
     t_print("%s: buffer overflow.\n", __FUNCTION__);
-    mybuf->free = 1;
+    seqstat_overflow(&mic_seqstat, 1);
+    mybuffer_release(mybuf);
     // skip 16 mic buffers (21 msec)
     mic_count = -16;
   }
 }
 
+//
+// Update the timing telemetry of a DDC upon arrival of a packet.
+// This is cheap: one clock_gettime() and a few floating point operations.
+//
+static void ddc_timing_update(int ddc, const unsigned char *buffer) {
+  //
+  // reference point for the drift calculation and last arrival,
+  // these are only used by the thread receiving this DDC.
+  //
+  static double t_first[MAX_DDC], t_last[MAX_DDC];
+  static long seq_first[MAX_DDC], seq_last[MAX_DDC];
+  static long long ts_first[MAX_DDC];
+  P2_DDC_TIMING *t = &ddc_timing[ddc];
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  double now = 1.0E6 * ts.tv_sec + 1.0E-3 * ts.tv_nsec;
+  long sequence = ((buffer[0] & 0xFF) << 24) + ((buffer[1] & 0xFF) << 16) + ((buffer[2] & 0xFF) << 8) + (buffer[3] & 0xFF);
+  long long timestamp = 0;
+
+  for (int i = 4; i < 12; i++) {
+    timestamp = (timestamp << 8) | (buffer[i] & 0xFF);
+  }
+
+  int samples = ((buffer[14] & 0xFF) << 8) + (buffer[15] & 0xFF);
+  int rate = ddc_rate[ddc];
+
+  // With PureSignal and Diversity, the packets contain two synchronized streams
+  if (rxcase[ddc] == RXACTION_PS || rxcase[ddc] == RXACTION_DIV) { samples /= 2; }
+
+  //
+  // A packet arriving late (or twice) must not disturb the statistics,
+  // it is only counted. A large step backwards means the radio has
+  // re-started its sequence numbers, this starts a new reference.
+  //
+  if (t->packets > 0 && sequence <= seq_last[ddc] && seq_last[ddc] - sequence < SEQSTAT_MAX_GAP) {
+    t->late++;
+    return;
+  }
+
+  if (ddc_timing_reset[ddc] || rate != t->rate || samples != t->samples || rate <= 0 || sequence <= seq_last[ddc]) {
+    ddc_timing_reset[ddc] = 0;
+    memset(t, 0, sizeof(P2_DDC_TIMING));
+    t->rate = rate;
+    t->samples = samples;
+    t->period = rate > 0 ? 1.0E6 * samples / rate : 0.0;
+    t_first[ddc] = now;
+    seq_first[ddc] = sequence;
+    ts_first[ddc] = timestamp;
+  } else {
+    double dev = fabs(now - t_last[ddc] - t->period * (sequence - seq_last[ddc]));
+    t->jitter += (dev - t->jitter) * 0.0625;
+
+    if (dev > t->max_deviation) { t->max_deviation = dev; }
+
+    if (now - t_last[ddc] < 0.25 * t->period) {
+      if (++t->burst > t->max_burst) { t->max_burst = t->burst; }
+    } else {
+      t->burst = 1;
+    }
+
+    //
+    // The radio's sample clock is given by the sequence number, which
+    // also accounts for lost packets. Drift is only meaningful after
+    // some time, so wait for 100 packets.
+    //
+    long nsamples = (sequence - seq_first[ddc]) * samples;
+
+    if (t->packets > 100) {
+      t->drift = 1.0E6 * ((1.0E6 * nsamples / rate) / (now - t_first[ddc]) - 1.0);
+    }
+
+    if (timestamp != 0) {
+      double expected = t->ticks_per_sample * samples * (sequence - seq_last[ddc]);
+
+      if (expected > 0.0 && fabs((double)(timestamp - t->timestamp) - expected) > 0.01 * expected) {
+        t->ts_errors++;
+      }
+
+      t->ticks_per_sample = (double)(timestamp - ts_first[ddc]) / (double) nsamples;
+    }
+  }
+
+  t->packets++;
+  t->timestamp = timestamp;
+  t_last[ddc] = now;
+  seq_last[ddc] = sequence;
+}
+
+//
+// Obtain (a copy of) the timing telemetry for a DDC.
+// Returns 0 on success and -1 if the DDC number is invalid.
+// Note the copy is made without locking, so the values in a copy
+// made while a packet arrives may be slightly inconsistent.
+//
+int new_protocol_ddc_timing(int ddc, P2_DDC_TIMING *timing) {
+  if (ddc < 0 || ddc >= MAX_DDC) { return -1; }
+
+  memcpy(timing, &ddc_timing[ddc], sizeof(P2_DDC_TIMING));
+  return 0;
+}
+
+//
+// Log the timing telemetry of all active DDCs. This is done when the
+// protocol stops, and every seqstat_dump seconds (see seqstat.h).
+//
+void new_protocol_ddc_timing_print() {
+  for (int i = 0; i < MAX_DDC; i++) {
+    P2_DDC_TIMING t;
+
+    if (new_protocol_ddc_timing(i, &t) == 0 && t.packets > 0) {
+      t_print("%s: DDC%d timing: %lld packets, rate=%d, period=%.1f usec, jitter=%.1f usec, max dev=%.1f usec, "
+              "max burst=%d, drift=%.1f ppm, ticks/sample=%.3f, ts errors=%lld, late=%lld\n", __FUNCTION__, i,
+              t.packets, t.rate, t.period, t.jitter, t.max_deviation, t.max_burst, t.drift,
+              t.ticks_per_sample, t.ts_errors, t.late);
+    }
+  }
+}
+
+//
+// Sequence number accounting for a DDC packet. This must be done by the
+// thread receiving the packets, before they are queued or processed.
+//
+static void ddc_sequence_check(int ddc, const unsigned char *buffer) {
+  uint32_t expected = ddc_seqstat[ddc].expected;
+  uint32_t sequence = ((buffer[0] & 0xFF) << 24) + ((buffer[1] & 0xFF) << 16) + ((buffer[2] & 0xFF) << 8) + (buffer[3] & 0xFF);
+
+  if (seqstat_packet(&ddc_seqstat[ddc], sequence) != SEQSTAT_OK) {
+    t_print("%s: DDC(%d) sequence error: expected %lu got %lu\n", __FUNCTION__, ddc,
+            (unsigned long) expected, (unsigned long) sequence);
+    sequence_errors++;
+  }
+}
+
 void saturn_post_iq_data(int ddc, mybuffer *mybuf) {
   if (ddc < 0 || ddc >= MAX_DDC) {
     t_print("%s: invalid DDC(%d) seen!\n", __FUNCTION__, ddc);
-    mybuf->free = 1;
+    mybuffer_release(mybuf);
     return;
   }
 
-  if (!P2running) {
-    mybuf->free = 1;
-    return;
-  }
+  ddc_timing_update(ddc, mybuf->buffer);
 
-  if (iq_count[ddc] < 0) {
-    iq_count[ddc]++;
-    mybuf->free = 1;
+  if (!P2running) {
+    mybuffer_release(mybuf);
     return;
   }
 
   //
-  // Check sequence HERE
+  // Check sequence HERE, before any buffers are skipped
   //
-  unsigned const char *buffer = mybuf->buffer;
-  unsigned long sequence = ((buffer[0] & 0xFF) << 24) + ((buffer[1] & 0xFF) << 16) + ((buffer[2] & 0xFF) << 8)
-                  + (buffer[3] & 0xFF);
+  ddc_sequence_check(ddc, mybuf->buffer);
 
-  if (ddc_sequence[ddc] != sequence) {
-    t_print("%s: DDC(%d) sequence error: expected %ld got %ld\n", __FUNCTION__, ddc, ddc_sequence[ddc], sequence);
-    sequence_errors++;
+  if (iq_count[ddc] < 0) {
+    iq_count[ddc]++;
+    seqstat_skipped(&ddc_seqstat[ddc], 1);
+    mybuffer_release(mybuf);
+    return;
   }
 
-  ddc_sequence[ddc] = sequence + 1;
   int iptr = iq_inptr[ddc];
   int nptr = iptr + 1;
 
@@ -2199,23 +2447,139 @@ void saturn_post_iq_data(int ddc, mybuffer *mybuf) {
 #endif
   } else {
     t_print("%s: DDC(%d) buffer overflow.\n", __FUNCTION__, ddc);
-    mybuf->free = 1;
+    seqstat_overflow(&ddc_seqstat[ddc], 1);
+    mybuffer_release(mybuf);
     // skip 128 incoming buffers
     iq_count[ddc] = -128;
   }
 }
 
-static gpointer iq_thread(gpointer data) {
-  int ddc = GPOINTER_TO_INT(data);
+//
+// Process one DDC packet according to the action table
+//
+static void process_ddc_packet(int ddc, const unsigned char *buffer) {
   //
-  // TEMPORARY: additional sequence check here
+  //  Now comes the action table:
+  //  for each DDC we have set up which action to be taken
+  //  (and, possibly, for which receiver)
   //
+  switch (rxcase[ddc]) {
+  case RXACTION_SKIP:
+    break;
+
+  case RXACTION_NORMAL:
+    process_iq_data(buffer, receiver[rxid[ddc]]);
+    break;
+
+  case RXACTION_PS:
+    process_ps_iq_data(buffer);
+    break;
+
+  case RXACTION_DIV:
+    process_div_iq_data(buffer);
+    break;
+  }
+}
+
+//
+// IQ thread main loop if the DDC has its own socket: receive (in batches
+// if recvmmsg is available) and process the packets directly, without
+// going through new_protocol_thread and the ring buffer.
+//
+#define DDC_RECV_BATCH 8
+
+static void ddc_socket_loop(int ddc) {
+  int sock = ddc_socket[ddc];
+  unsigned char (*rcvbuf)[NET_BUFFER_SIZE] = g_malloc(DDC_RECV_BATCH * NET_BUFFER_SIZE);
+  int len[DDC_RECV_BATCH];
+#ifdef HAVE_RECVMMSG
+  struct mmsghdr msgs[DDC_RECV_BATCH];
+  struct iovec iovecs[DDC_RECV_BATCH];
+  int use_recvmmsg = 1;
+#endif
+
+  while (1) {
+    int n = -1;
+#ifdef HAVE_RECVMMSG
+
+    if (use_recvmmsg) {
+      for (int i = 0; i < DDC_RECV_BATCH; i++) {
+        iovecs[i].iov_base = rcvbuf[i];
+        iovecs[i].iov_len = NET_BUFFER_SIZE;
+        memset(&msgs[i].msg_hdr, 0, sizeof(msgs[i].msg_hdr));
+        msgs[i].msg_hdr.msg_iov = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+      }
+
+      n = recvmmsg(sock, msgs, DDC_RECV_BATCH, MSG_WAITFORONE, NULL);
+
+      if (n < 0 && errno == ENOSYS) {
+        t_print("%s: recvmmsg not supported, using recvfrom\n", __FUNCTION__);
+        use_recvmmsg = 0;
+      }
+
+      for (int i = 0; i < n; i++) {
+        len[i] = msgs[i].msg_len;
+      }
+    }
+
+    if (!use_recvmmsg)
+#endif
+    {
+      n = recvfrom(sock, (char*)rcvbuf[0], NET_BUFFER_SIZE, 0, NULL, 0);
+
+      if (n >= 0) {
+        len[0] = n;
+        n = 1;
+      }
+    }
+
+    if (n < 0) {
+      if (errno == EINTR || errno == EAGAIN) { continue; }
+
+      t_perror("recvfrom DDC socket failed:");
+      exit(-1);
+    }
+
+    ddc_recv_calls[ddc]++;
+    ddc_recv_packets[ddc] += n;
+
+    if (!P2running) {
+      //
+      // Protocol stopped: discard data (new_protocol_menu_start
+      // re-syncs the sequence check)
+      //
+      continue;
+    }
+
+    for (int i = 0; i < n; i++) {
+      //
+      // A short (truncated) packet would be parsed from the stale
+      // contents of the buffer, so it is dropped and counted
+      //
+      if (len[i] < 16 || len[i] < 16 + 6 * iq_samples_per_frame(rcvbuf[i])) {
+        ddc_recv_short[ddc]++;
+        continue;
+      }
+
+      ddc_timing_update(ddc, rcvbuf[i]);
+      ddc_sequence_check(ddc, rcvbuf[i]);
+      process_ddc_packet(ddc, rcvbuf[i]);
+    }
+  }
+}
+
+static gpointer iq_thread(gpointer data) {
+  int ddc = GPOINTER_TO_INT(data);
   int nptr, optr;
-  long sequence;
-  long expected_sequence = 0;
   volatile mybuffer *mybuf;
-  const unsigned char *buffer;
   t_print("iq_thread: ddc=%d\n", ddc);
+  rtsched_apply(THREAD_ROLE_RX);
+
+  if (ddc_socket[ddc] >= 0) {
+    ddc_socket_loop(ddc);
+    return NULL;
+  }
 
   //
   // At a regular pace, a buffer with 238 samples arrives
@@ -2242,56 +2606,28 @@ static gpointer iq_thread(gpointer data) {
     // This can happen when restarting the protocol
     if (mybuf->free) { continue; }
 
-    buffer = (unsigned char *) mybuf->buffer;
-    //
-    //  TEMP: perform additional sequence check
-    //
-    sequence = ((buffer[0] & 0xFF) << 24) + ((buffer[1] & 0xFF) << 16) + ((buffer[2] & 0xFF) << 8) + (buffer[3] & 0xFF);
-
-    if (expected_sequence == 0) { expected_sequence = sequence; }
-
-    if (sequence != expected_sequence) {
-      t_print("%s: DDC(%d) sequence error: expected %ld got %ld\n", __FUNCTION__, ddc, expected_sequence, sequence);
-      sequence_errors++;
-    }
-
-    expected_sequence = sequence + 1;
-
-    //
-    //  Now comes the action table:
-    //  for each DDC we have set up which action to be taken
-    //  (and, possibly, for which receiver)
-    //
-    switch (rxcase[ddc]) {
-    case RXACTION_SKIP:
-      break;
-
-    case RXACTION_NORMAL:
-      process_iq_data(buffer, receiver[rxid[ddc]]);
-      break;
+    process_ddc_packet(ddc, (const unsigned char *) mybuf->buffer);
+    mybuffer_release((mybuffer *) mybuf);
+  }
 
-    case RXACTION_PS:
-      process_ps_iq_data(buffer);
-      break;
+  return NULL;
+}
 
-    case RXACTION_DIV:
-      process_div_iq_data(buffer);
-      break;
-    }
+//
+// Number of I/Q samples in a DDC packet, limited to what fits into a network buffer
+//
+static int iq_samples_per_frame(const unsigned char *buffer) {
+  int samplesperframe = ((buffer[14] & 0xFF) << 8) + (buffer[15] & 0xFF);
 
-    mybuf->free = 1;
+  if (samplesperframe > (NET_BUFFER_SIZE - 16) / 6) {
+    samplesperframe = (NET_BUFFER_SIZE - 16) / 6;
   }
 
-  return NULL;
+  return samplesperframe;
 }
 
 static void process_iq_data(const unsigned char *buffer, RECEIVER *rx) {
-  int b;
-  int leftsample;
-  int rightsample;
-  double leftsampledouble;
-  double rightsampledouble;
-  int samplesperframe = ((buffer[14] & 0xFF) << 8) + (buffer[15] & 0xFF);
+  int samplesperframe = iq_samples_per_frame(buffer);
 #ifdef P2IQDEBUG
   long long timestamp =
     ((long long)(buffer[4] & 0xFF) << 56)
@@ -2305,21 +2641,9 @@ static void process_iq_data(const unsigned char *buffer, RECEIVER *rx) {
   int bitspersample = ((buffer[12] & 0xFF) << 8) + (buffer[13] & 0xFF);
   t_print("%s: rx=%d bitspersample=%d samplesperframe=%d\n", __FUNCTION__, rx->id, bitspersample, samplesperframe);
 #endif
-  b = 16;
-  int i;
-
-  for (i = 0; i < samplesperframe; i++) {
-    leftsample   = (int)((signed char) buffer[b++]) << 16;
-    leftsample  |= (int)((((unsigned char)buffer[b++]) << 8) & 0xFF00);
-    leftsample  |= (int)((unsigned char)buffer[b++] & 0xFF);
-    rightsample  = (int)((signed char)buffer[b++]) << 16;
-    rightsample |= (int)((((unsigned char)buffer[b++]) << 8) & 0xFF00);
-    rightsample |= (int)((unsigned char)buffer[b++] & 0xFF);
-    // The "obscure" constant 1.1920928955078125E-7 is 1/(2^23)
-    leftsampledouble = (double)leftsample * 1.1920928955078125E-7;
-    rightsampledouble = (double)rightsample * 1.1920928955078125E-7;
-    add_iq_samples(rx, leftsampledouble, rightsampledouble);
-  }
+  double iq[2 * samplesperframe];
+  iq24_unpack_double(buffer + 16, iq, 2 * samplesperframe);
+  add_iq_samples_block_double(rx, iq, samplesperframe);
 }
 
 //
@@ -2327,16 +2651,7 @@ static void process_iq_data(const unsigned char *buffer, RECEIVER *rx) {
 // at the end
 //
 static void process_div_iq_data(const unsigned char*buffer) {
-  int b;
-  int leftsample0;
-  int rightsample0;
-  double leftsampledouble0;
-  double rightsampledouble0;
-  int leftsample1;
-  int rightsample1;
-  double leftsampledouble1;
-  double rightsampledouble1;
-  int samplesperframe = ((buffer[14] & 0xFF) << 8) + (buffer[15] & 0xFF);
+  int samplesperframe = iq_samples_per_frame(buffer);
 #ifdef P2IQDEBUG
   long long timestamp =
     ((long long)(buffer[4] & 0xFF) << 56)
@@ -2350,49 +2665,33 @@ static void process_div_iq_data(const unsigned char*buffer) {
   int bitspersample = ((buffer[12] & 0xFF) << 8) + (buffer[13] & 0xFF);
   t_print("%s: rx=%d bitspersample=%d samplesperframe=%d\n", __FUNCTION__, rx->id, bitspersample, samplesperframe);
 #endif
-  b = 16;
-  int i;
+  double iq[2 * samplesperframe];
+  iq24_unpack_double(buffer + 16, iq, 2 * samplesperframe);
 
-  for (i = 0; i < samplesperframe; i += 2) {
-    leftsample0   = (int)((signed char) buffer[b++]) << 16;
-    leftsample0  |= (int)((((unsigned char)buffer[b++]) << 8) & 0xFF00);
-    leftsample0  |= (int)((unsigned char)buffer[b++] & 0xFF);
-    rightsample0  = (int)((signed char)buffer[b++]) << 16;
-    rightsample0 |= (int)((((unsigned char)buffer[b++]) << 8) & 0xFF00);
-    rightsample0 |= (int)((unsigned char)buffer[b++] & 0xFF);
-    leftsampledouble0 = (double)leftsample0 * 1.1920928955078125E-7;
-    rightsampledouble0 = (double)rightsample0 * 1.1920928955078125E-7;
-    leftsample1   = (int)((signed char) buffer[b++]) << 16;
-    leftsample1  |= (int)((((unsigned char)buffer[b++]) << 8) & 0xFF00);
-    leftsample1  |= (int)((unsigned char)buffer[b++] & 0xFF);
-    rightsample1  = (int)((signed char)buffer[b++]) << 16;
-    rightsample1 |= (int)((((unsigned char)buffer[b++]) << 8) & 0xFF00);
-    rightsample1 |= (int)((unsigned char)buffer[b++] & 0xFF);
-    leftsampledouble1 = (double)leftsample1 * 1.1920928955078125E-7;
-    rightsampledouble1 = (double)rightsample1 * 1.1920928955078125E-7;
-    add_div_iq_samples(receiver[0], leftsampledouble0, rightsampledouble0, leftsampledouble1, rightsampledouble1);
+  //
+  // The two DDCs are interleaved, such that each group of
+  // four values contains I/Q for the first and the second DDC
+  //
+  int n = samplesperframe / 2;
+  add_div_iq_samples_block(receiver[0], iq, iq + 2, 4, n);
 
-    //
-    // if both receivers share the sample rate, we can feed data to RX2
-    //
-    if (receivers > 1 && (receiver[0]->sample_rate == receiver[1]->sample_rate)) {
-      add_iq_samples(receiver[1], leftsampledouble1, rightsampledouble1);
+  //
+  // if both receivers share the sample rate, we can feed data to RX2
+  //
+  if (receivers > 1 && (receiver[0]->sample_rate == receiver[1]->sample_rate)) {
+    double aux[2 * n];
+
+    for (int i = 0; i < n; i++) {
+      aux[2 * i]     = iq[4 * i + 2];
+      aux[2 * i + 1] = iq[4 * i + 3];
     }
+
+    add_iq_samples_block_double(receiver[1], aux, n);
   }
 }
 
 static void process_ps_iq_data(const unsigned char *buffer) {
-  int samplesperframe;
-  int b;
-  int leftsample0;
-  int rightsample0;
-  double leftsampledouble0;
-  double rightsampledouble0;
-  int leftsample1;
-  int rightsample1;
-  double leftsampledouble1;
-  double rightsampledouble1;
-  samplesperframe = ((buffer[14] & 0xFF) << 8) + (buffer[15] & 0xFF);
+  int samplesperframe = iq_samples_per_frame(buffer);
 #ifdef P2IQDEBUG
   long long timestamp =
     ((long long)(buffer[4] & 0xFF) << 56)
@@ -2406,38 +2705,22 @@ static void process_ps_iq_data(const unsigned char *buffer) {
   int bitspersample = ((buffer[12] & 0xFF) << 8) + (buffer[13] & 0xFF);
   t_print("%s: rx=%d bitspersample=%d samplesperframe=%d\n", __FUNCTION__, rx->id, bitspersample, samplesperframe);
 #endif
-  b = 16;
-  int i;
+  double iq[2 * samplesperframe];
+  iq24_unpack_double(buffer + 16, iq, 2 * samplesperframe);
 
-  for (i = 0; i < samplesperframe; i += 2) {
-    leftsample0   = (int)((signed char) buffer[b++]) << 16;
-    leftsample0  |= (int)((((unsigned char)buffer[b++]) << 8) & 0xFF00);
-    leftsample0  |= (int)((unsigned char)buffer[b++] & 0xFF);
-    rightsample0  = (int)((signed char)buffer[b++]) << 16;
-    rightsample0 |= (int)((((unsigned char)buffer[b++]) << 8) & 0xFF00);
-    rightsample0 |= (int)((unsigned char)buffer[b++] & 0xFF);
-    leftsampledouble0 = (double)leftsample0 * 1.1920928955078125E-7;
-    rightsampledouble0 = (double)rightsample0 * 1.1920928955078125E-7;
-    leftsample1   = (int)((signed char) buffer[b++]) << 16;
-    leftsample1  |= (int)((((unsigned char)buffer[b++]) << 8) & 0xFF00);
-    leftsample1  |= (int)((unsigned char)buffer[b++] & 0xFF);
-    rightsample1  = (int)((signed char)buffer[b++]) << 16;
-    rightsample1 |= (int)((((unsigned char)buffer[b++]) << 8) & 0xFF00);
-    rightsample1 |= (int)((unsigned char)buffer[b++] & 0xFF);
-    leftsampledouble1 = (double)leftsample1 * 1.1920928955078125E-7;
-    rightsampledouble1 = (double)rightsample1 * 1.1920928955078125E-7;
-    add_ps_iq_samples(transmitter, leftsampledouble1, rightsampledouble1, leftsampledouble0, rightsampledouble0);
-    //t_print("%06x,%06x %06x,%06x\n",leftsample0,rightsample0,leftsample1,rightsample1);
+  // groups of four values, an odd sample count leaves an incomplete group
+  for (int i = 0; i + 4 <= 2 * samplesperframe; i += 4) {
+    add_ps_iq_samples(transmitter, iq[i + 2], iq[i + 3], iq[i], iq[i + 1]);
 
 #if defined(DUMP_TX_DATA)
     if ((DUMP_TX_DATA == DUMP_TXFDBK) && (rxiq_count < 1000000)) {
-      rxiqi[rxiq_count]=leftsample1;
-      rxiqq[rxiq_count]=rightsample1;
+      rxiqi[rxiq_count]=(int) (iq[i + 2] * 8388608.0);
+      rxiqq[rxiq_count]=(int) (iq[i + 3] * 8388608.0);
       rxiq_count++;
     }
     if ((DUMP_TX_DATA == DUMP_RXFDBK) && (rxiq_count < 1000000)) {
-      rxiqi[rxiq_count]=leftsample0;
-      rxiqq[rxiq_count]=rightsample0;
+      rxiqi[rxiq_count]=(int) (iq[i] * 8388608.0);
+      rxiqq[rxiq_count]=(int) (iq[i + 1] * 8388608.0);
       rxiq_count++;
     }
 #endif
@@ -2446,7 +2729,7 @@ static void process_ps_iq_data(const unsigned char *buffer) {
 }
 
 static void process_high_priority() {
-  unsigned long sequence;
+  uint32_t sequence, expected;
   int previous_ptt;
   int previous_dot;
   int previous_dash;
@@ -2466,13 +2749,13 @@ static void process_high_priority() {
   const unsigned char *buffer = high_priority_buffer->buffer;
   sequence = ((buffer[0] & 0xFF) << 24) + ((buffer[1] & 0xFF) << 16) + ((buffer[2] & 0xFF) << 8) + (buffer[3] & 0xFF);
 
-  if (sequence != highprio_rcvd_sequence) {
-    t_print("HighPrio SeqErr Expected=%ld Seen=%ld\n", highprio_rcvd_sequence, sequence);
-    highprio_rcvd_sequence = sequence;
+  expected = hp_seqstat.expected;
+
+  if (seqstat_packet(&hp_seqstat, sequence) != SEQSTAT_OK) {
+    t_print("HighPrio SeqErr Expected=%lu Seen=%lu\n", (unsigned long) expected, (unsigned long) sequence);
     sequence_errors++;
   }
 
-  highprio_rcvd_sequence++;
   previous_ptt = radio_ptt;
   previous_dot = radio_dot;
   previous_dash = radio_dash;
@@ -2592,18 +2875,9 @@ static void process_high_priority() {
 }
 
 static void process_mic_data(const unsigned char *buffer) {
-  unsigned long sequence;
   int b;
   int i;
   float fsample;
-  sequence = ((buffer[0] & 0xFF) << 24) + ((buffer[1] & 0xFF) << 16) + ((buffer[2] & 0xFF) << 8) + (buffer[3] & 0xFF);
-
-  if (sequence != micsamples_sequence) {
-    t_print("MicSample SeqErr Expected=%ld Seen=%ld\n", micsamples_sequence, sequence);
-    sequence_errors++;
-  }
-
-  micsamples_sequence = sequence + 1;
   b = 4;
 
   for (i = 0; i < MIC_SAMPLES; i++) {
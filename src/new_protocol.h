@@ -21,6 +21,7 @@
 
 #include "MacOS.h"   // for semaphores
 #include "receiver.h"
+#include "bufpool.h"
 
 #define MAX_DDC 4
 
@@ -47,31 +48,15 @@
 #define RX_IQ_TO_HOST_PORT_6                          1041
 #define RX_IQ_TO_HOST_PORT_7                          1042
 
-// Network buffers
-// Maximum length is 1444
-
-#define NET_BUFFER_SIZE  1500
-
-/////////////////////////////////////////////////////////////////////////////
-//
-// PEDESTRIAN BUFFER MANAGEMENT
 //
-////////////////////////////////////////////////////////////////////////////
+// Length of the ring buffers that hold network buffers between
+// the receiving thread and the IQ / mic consumer threads. Since
+// a network buffer is either free, held by a thread, or sits in
+// one of these rings, they also determine the buffer pool size.
 //
-// One buffer. The fences can be used to detect over-writing
-// (feature currently not used).
-//
-////////////////////////////////////////////////////////////////////////////
-
-struct mybuffer_ {
-  struct mybuffer_ *next;
-  int             free;
-  long            lowfence;
-  unsigned char   buffer[NET_BUFFER_SIZE];
-  long            highfence;
-};
-
-typedef struct mybuffer_ mybuffer;
+#define RXIQRINGBUFLEN 512
+#define MICRINGBUFLEN 64
+#define NET_BUFFER_POOL_SIZE (MAX_DDC * (RXIQRINGBUFLEN + 1) + MICRINGBUFLEN + 16)
 
 #define MIC_SAMPLES 64
 
@@ -97,6 +82,32 @@ extern void saturn_post_iq_data(int ddc, mybuffer *buffer);
 extern void saturn_post_micaudio(int bytes, mybuffer *buffer);
 extern void saturn_post_high_priority(mybuffer *buffer);
 
+//
+// Per-DDC timing telemetry, derived from the arrival times (CLOCK_MONOTONIC)
+// of the DDC packets together with their sequence numbers and the 64-bit
+// time stamps the radio puts into bytes 4-11.
+// All values refer to the time since the last protocol (re-)start, or since
+// the last change of the DDC sample rate.
+//
+typedef struct _p2_ddc_timing {
+  long long packets;             // number of packets seen
+  int       rate;                // DDC sample rate (Hz) programmed into the radio
+  int       samples;             // I/Q samples per stream in the last packet
+  double    period;              // nominal inter-arrival time (usec)
+  double    jitter;              // smoothed |inter-arrival time - period| (usec, RFC 3550 style)
+  double    max_deviation;       // largest |inter-arrival time - period| (usec)
+  int       burst;               // current burst (packets arriving back-to-back)
+  int       max_burst;           // largest burst seen
+  double    drift;               // radio sample clock vs. host clock (ppm)
+  double    ticks_per_sample;    // time stamp increment per I/Q sample (0 if not provided)
+  long long timestamp;           // time stamp of the last packet
+  long long ts_errors;           // time stamp increments that do not match the sample count
+  long long late;                // packets arriving late or twice (not used for the above)
+} P2_DDC_TIMING;
+
+extern int new_protocol_ddc_timing(int ddc, P2_DDC_TIMING *timing);
+extern void new_protocol_ddc_timing_print(void);
+
 //
 // if DUMP_TX_DATA is #defined, the first 1000000 samples
 // after a RXTX transition are dumped to a file at the
@@ -45,6 +45,7 @@
 
 #define EXTERN extern
 #include "hpsdrsim.h"
+#include "iqunpack.h"
 
 #ifdef LOGFIRST
 static int first_tx_i[576000];
@@ -1357,7 +1358,7 @@ void *tx_thread(void * data) {
   int yes = 1;
   int rc;
   int i;
-  unsigned char *p;
+  int32_t txsamples[480];
   int samp1, samp2;
   double di, dq;
   double sum;
@@ -1438,17 +1439,13 @@ void *tx_thread(void * data) {
       txptr = NEWRTXLEN / 2;
     }
 
-    p = buffer + 4;
+    iq24_unpack_int(buffer + 4, txsamples, 480);
     sum = 0.0;
 
     for (i = 0; i < 240; i++) {
       // process 240 TX iq samples
-      samp1  = (int)((signed char) (*p++)) << 16;
-      samp1 |= (int)((((unsigned char)(*p++)) << 8) & 0xFF00);
-      samp1 |= (int)((unsigned char)(*p++) & 0xFF);
-      samp2  = (int)((signed char) (*p++)) << 16;
-      samp2 |= (int)((((unsigned char)(*p++)) << 8) & 0xFF00);
-      samp2 |= (int)((unsigned char)(*p++) & 0xFF);
+      samp1 = txsamples[2 * i];
+      samp2 = txsamples[2 * i + 1];
 
       di = (double) samp1 / 8388608.0;
       dq = (double) samp2 / 8388608.0;
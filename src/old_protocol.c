@@ -16,6 +16,10 @@
 *
 */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+  #define _GNU_SOURCE  // for recvmmsg()
+#endif
+
 #include <gtk/gtk.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -58,6 +62,8 @@
 #include "ext.h"
 #include "iambic.h"
 #include "message.h"
+#include "rtsched.h"
+#include "seqstat.h"
 #include "pihpsdr_win32.h"
 
 #ifdef _WIN32
@@ -138,6 +144,7 @@ static unsigned char control_in[5] = {0x00, 0x00, 0x00, 0x00, 0x00};
 static volatile int P1running = 0;
 
 static uint32_t last_seq_num = -0xffffffff;
+static SEQSTAT p1_seqstat;    // sequence and loss accounting (see seqstat.h)
 static int tx_fifo_flag = 0;
 
 static int current_rx = 0;
@@ -167,6 +174,8 @@ static int metis_write(unsigned char ep, unsigned const char* buffer, int length
 static void metis_start_stop(int command);
 static void metis_send_buffer(unsigned char* buffer, int length);
 static void metis_restart(void);
+static void metis_recv_stats(void);
+static void rxring_stats(void);
 
 static void open_tcp_socket(void);
 static void open_udp_socket(void);
@@ -253,14 +262,34 @@ static volatile int txring_drain  = 0;  // a flag for draining the output buffer
 // corresponds to 480 kByte (PS, 5RX, 192k) or
 // 400 kByyte (2RX, 384k), so we use 512k
 //
+// The ring buffer has exactly one producer (the METIS or OZYEP6 thread)
+// and one consumer (the P1 proc thread), so it is lock-free.
+// The write and read pointers live in different cache lines such that
+// producer and consumer do not compete for the same cache line.
+// The consumer drains everything that is available upon each wake-up
+// and only sleeps on the semaphore if the ring buffer is empty, so
+// the producer only has to post the semaphore if the consumer is
+// actually waiting.
+//
 #define RXRINGBUFLEN 524288  // must be multiple of 1024 since we queue double-buffers
+#define RXRING_CACHE_LINE 128
 static unsigned char *RXRINGBUF = NULL;
-static volatile int rxring_inptr  = 0;  // pointer updated when writing into the ring buffer
-static volatile int rxring_outptr = 0;  // pointer updated when reading from the ring buffer
-static volatile int rxring_count  = 0;  // a sample counter
+
+static struct {
+  volatile int inptr;                 // updated (only) by the producer when writing into the ring buffer
+  char pad1[RXRING_CACHE_LINE - sizeof(int)];
+  volatile int outptr;                // updated (only) by the consumer when reading from the ring buffer
+  char pad2[RXRING_CACHE_LINE - sizeof(int)];
+  volatile int waiting;               // consumer is (about to) sleep on rxring_sem
+  char pad3[RXRING_CACHE_LINE - sizeof(int)];
+  int high_water;                     // max. number of queued buffer pairs seen (producer only)
+  int overflow;                       // number of buffer pairs dropped (producer only)
+  int burst;                          // overflow burst in progress (producer only)
+} rxring __attribute__((aligned(RXRING_CACHE_LINE)));
 
 static gpointer old_protocol_txiq_thread(gpointer data) {
   int nptr;
+  rtsched_apply(THREAD_ROLE_TX);
 
   //
   // Ideally, an output METIS buffer with 126 samples is sent every 2625 usec.
@@ -407,6 +436,8 @@ void old_protocol_stop() {
   t_print("%s\n", __FUNCTION__);
   metis_start_stop(0);
   pthread_mutex_unlock(&send_ozy_mutex);
+  metis_recv_stats();
+  rxring_stats();
 }
 
 void old_protocol_run() {
@@ -428,6 +459,7 @@ void old_protocol_set_mic_sample_rate(int rate) {
 void old_protocol_init(int rate) {
   int i;
   t_print("old_protocol_init: num_hpsdr_receivers=%d\n", how_many_receivers());
+  seqstat_register(&p1_seqstat, "P1");
 
   if (TXRINGBUF == NULL) {
     TXRINGBUF = g_new(unsigned char, TXRINGBUFLEN);
@@ -586,6 +618,7 @@ static gpointer ozy_i2c_thread(gpointer arg) {
 //
 static gpointer ozy_ep6_rx_thread(gpointer arg) {
   t_print( "old_protocol: USB EP6 receive_thread\n");
+  rtsched_apply(THREAD_ROLE_RX);
   static unsigned char ep6_inbuffer[EP6_BUFFER_SIZE];
 
   for (;;) {
@@ -861,16 +894,158 @@ static void open_tcp_socket() {
   t_print("TCP socket established: %d\n", tcp_socket);
 }
 
+//
+// Batched UDP receive.
+// At high sample rates, thousands of METIS datagrams per second arrive
+// from the radio. Where available (Linux), recvmmsg() is used to pull
+// up to METIS_RECV_BATCH datagrams out of the socket with a single
+// system call into a pre-allocated array of buffers. On other platforms,
+// or if the kernel does not support recvmmsg(), we fall back to one
+// recvfrom() per datagram.
+//
+// The counters are for tuning METIS_RECV_BATCH, they are reported when
+// the protocol is stopped. Note the time spent in the system call
+// includes the time waiting for the first datagram.
+//
+#if defined(__linux__) && defined(MSG_WAITFORONE)
+  #define HAVE_RECVMMSG
+#endif
+
+#define METIS_RECV_BATCH 16
+
+static unsigned char metis_rcvbuf[METIS_RECV_BATCH][1032];
+static int metis_rcvlen[METIS_RECV_BATCH];
+
+#ifdef HAVE_RECVMMSG
+  static struct mmsghdr metis_msgs[METIS_RECV_BATCH];
+  static struct iovec metis_iovecs[METIS_RECV_BATCH];
+  static int use_recvmmsg = 1;
+#endif
+
+static long long metis_recv_calls = 0;    // number of receive system calls that delivered data
+static long long metis_recv_packets = 0;  // number of datagrams received
+static long long metis_recv_nsec = 0;     // time spent in these system calls
+
+static void metis_recv_stats() {
+  if (metis_recv_calls > 0) {
+    t_print("%s: %lld syscalls, %lld packets, avg batch=%.2f, avg time per syscall=%.1f usec\n", __FUNCTION__,
+            metis_recv_calls, metis_recv_packets, (double) metis_recv_packets / (double) metis_recv_calls,
+            1.0E-3 * (double) metis_recv_nsec / (double) metis_recv_calls);
+  }
+}
+
+//
+// Receive one or more datagrams from data_socket into metis_rcvbuf.
+// Returns the number of datagrams received, or a negative value
+// in case of an error or time-out (see errno)
+//
+static int metis_udp_receive() {
+  struct timespec ts0, ts1;
+  int n = -1;
+  clock_gettime(CLOCK_MONOTONIC, &ts0);
+#ifdef HAVE_RECVMMSG
+
+  if (use_recvmmsg) {
+    for (int i = 0; i < METIS_RECV_BATCH; i++) {
+      metis_iovecs[i].iov_base = metis_rcvbuf[i];
+      metis_iovecs[i].iov_len = sizeof(metis_rcvbuf[i]);
+      memset(&metis_msgs[i].msg_hdr, 0, sizeof(metis_msgs[i].msg_hdr));
+      metis_msgs[i].msg_hdr.msg_iov = &metis_iovecs[i];
+      metis_msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    n = recvmmsg(data_socket, metis_msgs, METIS_RECV_BATCH, MSG_WAITFORONE, NULL);
+
+    if (n < 0 && errno == ENOSYS) {
+      t_print("%s: recvmmsg not supported, using recvfrom\n", __FUNCTION__);
+      use_recvmmsg = 0;
+    } else {
+      for (int i = 0; i < n; i++) {
+        metis_rcvlen[i] = metis_msgs[i].msg_len;
+      }
+    }
+  }
+
+  if (!use_recvmmsg)
+#endif
+  {
+    n = recvfrom(data_socket, (char*)metis_rcvbuf[0], sizeof(metis_rcvbuf[0]), 0, NULL, 0);
+
+    if (n >= 0) {
+      metis_rcvlen[0] = n;
+      n = 1;
+    }
+  }
+
+  if (n > 0) {
+    clock_gettime(CLOCK_MONOTONIC, &ts1);
+    metis_recv_calls++;
+    metis_recv_packets += n;
+    metis_recv_nsec += (ts1.tv_sec - ts0.tv_sec) * 1000000000LL + (ts1.tv_nsec - ts0.tv_nsec);
+  }
+
+  return n;
+}
+
+static void process_metis_packet(unsigned const char *buffer, int bytes_read) {
+  int ep;
+  uint32_t sequence;
+
+  if (buffer[0] == 0xEF && buffer[1] == 0xFE) {
+    switch (buffer[2]) {
+    case 1:
+      // get the end point
+      ep = buffer[3] & 0xFF;
+      // get the sequence number
+      sequence = ((buffer[4] & 0xFF) << 24) + ((buffer[5] & 0xFF) << 16) + ((buffer[6] & 0xFF) << 8) + (buffer[7] & 0xFF);
+
+      // A sequence error with a seqnum of zero usually indicates a METIS restart
+      // and is no error condition
+      if (sequence == 0) { seqstat_resync(&p1_seqstat); }
+
+      if (seqstat_packet(&p1_seqstat, sequence) != SEQSTAT_OK) {
+        t_print("SEQ ERROR: last %ld, recvd %ld\n", (long) last_seq_num, (long) sequence);
+        sequence_errors++;
+      }
+
+      last_seq_num = sequence;
+
+      switch (ep) {
+      case 6: // EP6
+        // process the data
+        queue_two_ozy_input_buffers(&buffer[8], &buffer[520]);
+        break;
+
+      case 4: // EP4
+        // not implemented
+        break;
+
+      default:
+        t_print("unexpected EP %d length=%d\n", ep, bytes_read);
+        break;
+      }
+
+      break;
+
+    case 2:  // response to a discovery packet
+      t_print("unexepected discovery response when not in discovery mode\n");
+      break;
+
+    default:
+      t_print("unexpected packet type: 0x%02X\n", buffer[2]);
+      break;
+    }
+  } else {
+    t_print("received bad header bytes on data port %02X,%02X\n", buffer[0], buffer[1]);
+  }
+}
+
 static gpointer receive_thread(gpointer arg) {
-  struct sockaddr_in addr;
-  socklen_t length;
-  unsigned char buffer[1032];
   int bytes_read;
+  int npackets;
   int ret, left;
-  int ep;
-  uint32_t sequence;
   t_print( "old_protocol: receive_thread\n");
-  length = sizeof(addr);
+  rtsched_apply(THREAD_ROLE_RX);
 
   for (;;) {
     switch (device) {
@@ -887,7 +1062,7 @@ static gpointer receive_thread(gpointer arg) {
           left = 1032;
 
           while (left > 0) {
-            ret = recvfrom(tcp_socket, (char*)buffer + bytes_read, (size_t)(left), 0, NULL, 0);
+            ret = recvfrom(tcp_socket, (char*)metis_rcvbuf[0] + bytes_read, (size_t)(left), 0, NULL, 0);
 
             if (ret < 0 && errno == EAGAIN) { continue; } // time-out
 
@@ -898,14 +1073,15 @@ static gpointer receive_thread(gpointer arg) {
           }
 
           if (ret < 0) {
-            bytes_read = ret;                        // error case: discard whole packet
+            npackets = ret;                          // error case: discard whole packet
+          } else {
+            metis_rcvlen[0] = bytes_read;
+            npackets = 1;
           }
         } else if (data_socket >= 0) {
-          bytes_read = recvfrom(data_socket, (char*)buffer, sizeof(buffer), 0, (struct sockaddr*)&addr, &length);
-
-          if (bytes_read < 0 && errno != EAGAIN) { t_perror("old_protocol recvfrom UDP:"); }
+          npackets = metis_udp_receive();
 
-          //t_print("%s: bytes_read=%d\n",__FUNCTION__,bytes_read);
+          if (npackets < 0 && errno != EAGAIN) { t_perror("old_protocol recvfrom UDP:"); }
         } else {
           //
           // This could happen in METIS start/stop sequences when using TCP
@@ -914,60 +1090,18 @@ static gpointer receive_thread(gpointer arg) {
           continue;
         }
 
-        if (bytes_read >= 0 || errno != EAGAIN) { break; }
+        if (npackets >= 0 || errno != EAGAIN) { break; }
       }
 
-      //
-      // If the protocol has been stopped, just swallow all incoming packets
-      //
-      if (bytes_read <= 0 || !P1running) {
-        continue;
-      }
-
-      if (buffer[0] == 0xEF && buffer[1] == 0xFE) {
-        switch (buffer[2]) {
-        case 1:
-          // get the end point
-          ep = buffer[3] & 0xFF;
-          // get the sequence number
-          sequence = ((buffer[4] & 0xFF) << 24) + ((buffer[5] & 0xFF) << 16) + ((buffer[6] & 0xFF) << 8) + (buffer[7] & 0xFF);
-
-          // A sequence error with a seqnum of zero usually indicates a METIS restart
-          // and is no error condition
-          if (sequence != 0 && sequence != last_seq_num + 1) {
-            t_print("SEQ ERROR: last %ld, recvd %ld\n", (long) last_seq_num, (long) sequence);
-            sequence_errors++;
-          }
-
-          last_seq_num = sequence;
-
-          switch (ep) {
-          case 6: // EP6
-            // process the data
-            queue_two_ozy_input_buffers(&buffer[8], &buffer[520]);
-            break;
-
-          case 4: // EP4
-            // not implemented
-            break;
-
-          default:
-            t_print("unexpected EP %d length=%d\n", ep, bytes_read);
-            break;
-          }
-
-          break;
-
-        case 2:  // response to a discovery packet
-          t_print("unexepected discovery response when not in discovery mode\n");
-          break;
-
-        default:
-          t_print("unexpected packet type: 0x%02X\n", buffer[2]);
-          break;
+      for (int i = 0; i < npackets; i++) {
+        //
+        // If the protocol has been stopped, just swallow all incoming packets
+        //
+        if (metis_rcvlen[i] <= 0 || !P1running) {
+          continue;
         }
-      } else {
-        t_print("received bad header bytes on data port %02X,%02X\n", buffer[0], buffer[1]);
+
+        process_metis_packet(metis_rcvbuf[i], metis_rcvlen[i]);
       }
 
       break;
@@ -1422,6 +1556,87 @@ static int st_num_hpsdr_receivers;
 static int st_rxfdbk;
 static int st_txfdbk;
 
+//
+// Deliver the I/Q sample of HPSDR receiver #n to the RX, diversity, or
+// PureSignal engine. Within one sample slot, this must be called for
+// n = 0, 1, ... in ascending order.
+//
+static void process_iq_sample(int n, double i_sample, double q_sample) {
+  if (isTransmitting() && transmitter->puresignal) {
+    //
+    // transmitting with PureSignal. Get sample pairs and feed to pscc
+    //
+    if (n == st_rxfdbk) {
+      left_sample_double_rx = i_sample;
+      right_sample_double_rx = q_sample;
+    } else if (n == st_txfdbk) {
+      left_sample_double_tx = i_sample;
+      right_sample_double_tx = q_sample;
+    }
+
+    // this is pure paranoia, it allows for st_txfdbk < st_rxfdbk
+    if (n + 1 == st_num_hpsdr_receivers) {
+      add_ps_iq_samples(transmitter, left_sample_double_tx, right_sample_double_tx, left_sample_double_rx,
+                        right_sample_double_rx);
+    }
+  }
+
+  if (!isTransmitting() && diversity_enabled) {
+    //
+    // receiving with DIVERSITY. Get sample pairs and feed to diversity mixer.
+    // If the second RX is running, feed aux samples to that receiver.
+    //
+    if (n == 0) {
+      left_sample_double_main = i_sample;
+      right_sample_double_main = q_sample;
+    } else if (n == 1) {
+      left_sample_double_aux = i_sample;
+      right_sample_double_aux = q_sample;
+      add_div_iq_samples(receiver[0], left_sample_double_main, right_sample_double_main, left_sample_double_aux,
+                         right_sample_double_aux);
+
+      if (receivers > 1) { add_iq_samples(receiver[1], left_sample_double_aux, right_sample_double_aux); }
+    }
+  }
+
+  if ((!isTransmitting() || duplex) && !diversity_enabled) {
+    //
+    // RX without DIVERSITY. Feed samples to RX1 and RX2
+    //
+    if (n == 0) {
+      add_iq_samples(receiver[0], i_sample, q_sample);
+    } else if (n == 1 && receivers > 1) {
+      add_iq_samples(receiver[1], i_sample, q_sample);
+    }
+  }
+}
+
+static void process_mic_sample(short sample) {
+  mic_samples++;
+
+  if (mic_samples >= mic_sample_divisor) { // reduce to 48000
+    //
+    // if radio_ptt is set, this usually means the PTT at the microphone connected
+    // to the SDR is pressed. In this case, we take audio from BOTH sources
+    // then we can use a "voice keyer" on some loop-back interface but at the same
+    // time use our microphone.
+    // In most situations only one source will be active so we just add.
+    //
+    float fsample;
+
+    if (radio_ptt) {
+      fsample = (float) sample * 0.00003051;
+
+      if (transmitter->local_microphone) { fsample += audio_get_next_mic_sample(); }
+    } else {
+      fsample = transmitter->local_microphone ? audio_get_next_mic_sample() : (float) sample * 0.00003051;
+    }
+
+    add_mic_sample(transmitter, fsample);
+    mic_samples = 0;
+  }
+}
+
 static void process_ozy_byte(int b) {
   switch (state) {
   case SYNC_0:
@@ -1503,55 +1718,7 @@ static void process_ozy_byte(int b) {
   case RIGHT_SAMPLE_LOW:
     right_sample |= (int)((unsigned char)b & 0xFF);
     right_sample_double = (double)right_sample * 1.1920928955078125E-7;
-
-    if (isTransmitting() && transmitter->puresignal) {
-      //
-      // transmitting with PureSignal. Get sample pairs and feed to pscc
-      //
-      if (nreceiver == st_rxfdbk) {
-        left_sample_double_rx = left_sample_double;
-        right_sample_double_rx = right_sample_double;
-      } else if (nreceiver == st_txfdbk) {
-        left_sample_double_tx = left_sample_double;
-        right_sample_double_tx = right_sample_double;
-      }
-
-      // this is pure paranoia, it allows for st_txfdbk < st_rxfdbk
-      if (nreceiver + 1 == st_num_hpsdr_receivers) {
-        add_ps_iq_samples(transmitter, left_sample_double_tx, right_sample_double_tx, left_sample_double_rx,
-                          right_sample_double_rx);
-      }
-    }
-
-    if (!isTransmitting() && diversity_enabled) {
-      //
-      // receiving with DIVERSITY. Get sample pairs and feed to diversity mixer.
-      // If the second RX is running, feed aux samples to that receiver.
-      //
-      if (nreceiver == 0) {
-        left_sample_double_main = left_sample_double;
-        right_sample_double_main = right_sample_double;
-      } else if (nreceiver == 1) {
-        left_sample_double_aux = left_sample_double;
-        right_sample_double_aux = right_sample_double;
-        add_div_iq_samples(receiver[0], left_sample_double_main, right_sample_double_main, left_sample_double_aux,
-                           right_sample_double_aux);
-
-        if (receivers > 1) { add_iq_samples(receiver[1], left_sample_double_aux, right_sample_double_aux); }
-      }
-    }
-
-    if ((!isTransmitting() || duplex) && !diversity_enabled) {
-      //
-      // RX without DIVERSITY. Feed samples to RX1 and RX2
-      //
-      if (nreceiver == 0) {
-        add_iq_samples(receiver[0], left_sample_double, right_sample_double);
-      } else if (nreceiver == 1 && receivers > 1) {
-        add_iq_samples(receiver[1], left_sample_double, right_sample_double);
-      }
-    }
-
+    process_iq_sample(nreceiver, left_sample_double, right_sample_double);
     nreceiver++;
 
     if (nreceiver == st_num_hpsdr_receivers) {
@@ -1569,30 +1736,7 @@ static void process_ozy_byte(int b) {
 
   case MIC_SAMPLE_LOW:
     mic_sample |= (short)(b & 0xFF);
-    mic_samples++;
-
-    if (mic_samples >= mic_sample_divisor) { // reduce to 48000
-      //
-      // if radio_ptt is set, this usually means the PTT at the microphone connected
-      // to the SDR is pressed. In this case, we take audio from BOTH sources
-      // then we can use a "voice keyer" on some loop-back interface but at the same
-      // time use our microphone.
-      // In most situations only one source will be active so we just add.
-      //
-      float fsample;
-
-      if (radio_ptt) {
-        fsample = (float) mic_sample * 0.00003051;
-
-        if (transmitter->local_microphone) { fsample += audio_get_next_mic_sample(); }
-      } else {
-        fsample = transmitter->local_microphone ? audio_get_next_mic_sample() : (float) mic_sample * 0.00003051;
-      }
-
-      add_mic_sample(transmitter, fsample);
-      mic_samples = 0;
-    }
-
+    process_mic_sample(mic_sample);
     nsamples++;
 
     if (nsamples == iq_samples) {
@@ -1606,38 +1750,176 @@ static void process_ozy_byte(int b) {
   }
 }
 
+//
+// Fast path: decode a complete 512-byte EP6 frame in one go.
+//
+// If the state machine is at a frame boundary and the frame starts
+// with the three SYNC bytes, the control bytes are processed once
+// and then all I/Q and mic fields of the frame are unpacked, in
+// tight loops, into per-receiver sample arrays before they are
+// delivered. Otherwise (this happens after data corruption) the
+// frame is fed byte-by-byte through process_ozy_byte(), which
+// re-synchronizes on the next frame boundary.
+//
+#define P1_MAX_RECEIVERS 8
+#define P1_MAX_FRAME_SAMPLES 63
+
+//
+// Deliver the I/Q samples of a complete frame. This does the same
+// as calling process_iq_sample() for each sample slot, but the RX
+// and diversity engines get the samples en bloc.
+//
+static void process_iq_block(int nrx, double iq[][2 * P1_MAX_FRAME_SAMPLES], int nsmp) {
+  int xmit = isTransmitting();
+
+  if (xmit && transmitter->puresignal && st_rxfdbk < nrx && st_txfdbk < nrx) {
+    const double *rxfdbk = iq[st_rxfdbk];
+    const double *txfdbk = iq[st_txfdbk];
+
+    for (int j = 0; j < nsmp; j++) {
+      add_ps_iq_samples(transmitter, txfdbk[2 * j], txfdbk[2 * j + 1], rxfdbk[2 * j], rxfdbk[2 * j + 1]);
+    }
+  }
+
+  if (!xmit && diversity_enabled && nrx > 1) {
+    add_div_iq_samples_block(receiver[0], iq[0], iq[1], 2, nsmp);
+
+    if (receivers > 1) { add_iq_samples_block_double(receiver[1], iq[1], nsmp); }
+  }
+
+  if ((!xmit || duplex) && !diversity_enabled) {
+    add_iq_samples_block_double(receiver[0], iq[0], nsmp);
+
+    if (nrx > 1 && receivers > 1) { add_iq_samples_block_double(receiver[1], iq[1], nsmp); }
+  }
+}
+
+static void process_ozy_input_buffer(unsigned const char *buffer) {
+  double iq[P1_MAX_RECEIVERS][2 * P1_MAX_FRAME_SAMPLES];
+  short mic[P1_MAX_FRAME_SAMPLES];
+  int nrx = st_num_hpsdr_receivers;
+
+  if (state != SYNC_0 || nrx < 1 || nrx > P1_MAX_RECEIVERS ||
+      buffer[SYNC0] != SYNC || buffer[SYNC1] != SYNC || buffer[SYNC2] != SYNC) {
+    for (int i = 0; i < OZY_BUFFER_SIZE; i++) {
+      process_ozy_byte(buffer[i] & 0xFF);
+    }
+
+    return;
+  }
+
+  memcpy(control_in, buffer + C0, 5);
+  process_control_bytes();
+  //
+  // Each sample slot consists of 6 bytes I/Q per receiver plus 2 bytes mic,
+  // padding bytes at the end of the frame are ignored.
+  //
+  int stride = (nrx * 6) + 2;
+  int nsmp = (OZY_BUFFER_SIZE - 8) / stride;
+
+  for (int r = 0; r < nrx; r++) {
+    unsigned const char *p = buffer + 8 + 6 * r;
+    double *dst = iq[r];
+
+    for (int j = 0; j < nsmp; j++, p += stride) {
+      int isample = ((signed char)p[0] << 16) | (p[1] << 8) | p[2];
+      int qsample = ((signed char)p[3] << 16) | (p[4] << 8) | p[5];
+      // The "obscure" constant 1.1920928955078125E-7 is 1/(2^23)
+      dst[2 * j]     = (double)isample * 1.1920928955078125E-7;
+      dst[2 * j + 1] = (double)qsample * 1.1920928955078125E-7;
+    }
+  }
+
+  unsigned const char *p = buffer + 8 + 6 * nrx;
+
+  for (int j = 0; j < nsmp; j++, p += stride) {
+    mic[j] = (short)((p[0] << 8) | p[1]);
+  }
+
+  process_iq_block(nrx, iq, nsmp);
+
+  for (int j = 0; j < nsmp; j++) {
+    process_mic_sample(mic[j]);
+  }
+}
+
 static void queue_two_ozy_input_buffers(unsigned const char *buf1,
                                         unsigned const char *buf2) {
   //
   // To achieve minimum overhead in the RX thread, the data is
   // simply put into a large ring buffer. We queue two buffers
-  // in one shot since this halves the number of semamphore operations
-  // at no cost (buffer fly in in pairs anyway)
+  // in one shot since buffers fly in in pairs anyway.
   //
-  if (rxring_count < 0) {
-    rxring_count++;
+  int iptr = rxring.inptr;
+  int nptr = iptr + 1024;
+
+  if (nptr >= RXRINGBUFLEN) { nptr = 0; }
+
+  if (nptr == g_atomic_int_get(&rxring.outptr)) {
+    //
+    // Ring buffer full: drop this buffer pair
+    //
+    if (!rxring.burst) {
+      t_print("%s: input buffer overflow.\n", __FUNCTION__);
+      rxring.burst = 1;
+      seqstat_overflow(&p1_seqstat, 1);
+    } else {
+      seqstat_skipped(&p1_seqstat, 1);
+    }
+
+    rxring.overflow++;
     return;
   }
 
-  int nptr = rxring_inptr + 1024;
+  rxring.burst = 0;
+  memcpy((void *)(&RXRINGBUF[iptr    ]), buf1, 512);
+  memcpy((void *)(&RXRINGBUF[iptr + 512]), buf2, 512);
+  g_atomic_int_set(&rxring.inptr, nptr);
+  int fill = (nptr - g_atomic_int_get(&rxring.outptr) + RXRINGBUFLEN) % RXRINGBUFLEN / 1024;
 
-  if (nptr >= RXRINGBUFLEN) { nptr = 0; }
+  if (fill > rxring.high_water) { rxring.high_water = fill; }
 
-  if (nptr != rxring_outptr) {
-    memcpy((void *)(&RXRINGBUF[rxring_inptr    ]), buf1, 512);
-    memcpy((void *)(&RXRINGBUF[rxring_inptr + 512]), buf2, 512);
-    MEMORY_BARRIER;
-    rxring_inptr = nptr;
+  //
+  // Wake up the consumer only if it sleeps on the semaphore
+  //
+  if (g_atomic_int_get(&rxring.waiting) && g_atomic_int_compare_and_exchange(&rxring.waiting, 1, 0)) {
 #ifdef __APPLE__
     sem_post(rxring_sem);
 #else
     sem_post(&rxring_sem);
 #endif
-  } else {
-    t_print("%s: input buffer overflow.\n", __FUNCTION__);
-    // if an overflow is encountered, skip the next 256 input buffers
-    // to allow a "fresh start"
-    rxring_count = -256;
+  }
+}
+
+static void rxring_stats() {
+  SEQSTAT_REPORT report;
+  t_print("%s: high-water mark %d of %d buffer pairs, %d buffer pairs dropped\n", __FUNCTION__,
+          rxring.high_water, RXRINGBUFLEN / 1024 - 1, rxring.overflow);
+
+  if (seqstat_lookup(p1_seqstat.name, &report) == 0) { seqstat_print(&report); }
+}
+
+//
+// Wait until there is data in the input ring buffer.
+// Note a "spurious" wake-up is harmless since we loop until
+// the ring buffer is non-empty.
+//
+static void rxring_wait() {
+  for (;;) {
+    if (rxring.outptr != g_atomic_int_get(&rxring.inptr)) { return; }
+
+    g_atomic_int_set(&rxring.waiting, 1);
+
+    if (rxring.outptr != g_atomic_int_get(&rxring.inptr)) {
+      g_atomic_int_set(&rxring.waiting, 0);
+      return;
+    }
+
+#ifdef __APPLE__
+    sem_wait(rxring_sem);
+#else
+    sem_wait(&rxring_sem);
+#endif
   }
 }
 
@@ -1646,48 +1928,120 @@ static gpointer process_ozy_input_buffer_thread(gpointer arg) {
   // This thread constantly monitors the input ring buffer and
   // processes the data whenever a bunch is available. Note this
   // thread does all the fexchange() with WDSP, since it calls
-  // (via process_ozy_byte)
+  // (via process_ozy_input_buffer)
   //
   // add_iq_samples   ==> RX engine(s)
   // add_mic_sample   ==> TX engine
   //
-  for (;;) {
-#ifdef __APPLE__
-    sem_wait(rxring_sem);
-#else
-    sem_wait(&rxring_sem);
-#endif
-    int nptr = rxring_outptr + 1024;
+  rtsched_apply(THREAD_ROLE_RX);
 
-    if (nptr >= RXRINGBUFLEN) { nptr = 0; }
+  for (;;) {
+    rxring_wait();
 
     //
-    // This data can change while processing one buffer
+    // Drain all buffer pairs that are available
     //
-    st_num_hpsdr_receivers = how_many_receivers();
-    st_rxfdbk = rx_feedback_channel();
-    st_txfdbk = tx_feedback_channel();
+    while (rxring.outptr != g_atomic_int_get(&rxring.inptr)) {
+      int optr = rxring.outptr;
+      int nptr = optr + 1024;
 
-    for (int i = 0; i < 1024; i++) {
-      process_ozy_byte(RXRINGBUF[rxring_outptr + i] & 0xFF);
-    }
+      if (nptr >= RXRINGBUFLEN) { nptr = 0; }
 
-    MEMORY_BARRIER;
-    rxring_outptr = nptr;
+      //
+      // This data can change while processing one buffer
+      //
+      st_num_hpsdr_receivers = how_many_receivers();
+      st_rxfdbk = rx_feedback_channel();
+      st_txfdbk = tx_feedback_channel();
+      process_ozy_input_buffer(&RXRINGBUF[optr]);
+      process_ozy_input_buffer(&RXRINGBUF[optr + 512]);
+      g_atomic_int_set(&rxring.outptr, nptr);
+    }
   }
 
   return NULL;
 }
 
-void old_protocol_audio_samples(short left_audio_sample, short right_audio_sample) {
-  if (!isTransmitting()) {
-    pthread_mutex_lock(&send_audio_mutex);
+//
+// Put one EP2 sample (L/R audio, I/Q) into the TX ring buffer, and wake
+// up the TX thread each time a complete METIS buffer (126 samples) is
+// filled. This must be called with send_audio_mutex locked.
+//
+static void txring_put_sample(int left, int right, int isample, int qsample) {
+  if (txring_count < 0) {
+    txring_count++;
+    return;
+  }
 
-    if (txring_count < 0) {
-      txring_count++;
-      pthread_mutex_unlock(&send_audio_mutex);
-      return;
+  int iptr = txring_inptr + 8 * txring_count;
+
+  //
+  // The HL2 makes no use of audio samples, but instead
+  // uses them to write to extended addrs which we do not
+  // want to do un-intentionally, therefore send zeros.
+  // Note special variants of the HL2 *do* have an audio codec!
+  //
+  if (device == DEVICE_HERMES_LITE2 && !hl2_audio_codec) {
+    TXRINGBUF[iptr++] = 0;
+    TXRINGBUF[iptr++] = 0;
+    TXRINGBUF[iptr++] = 0;
+    TXRINGBUF[iptr++] = 0;
+  } else {
+    TXRINGBUF[iptr++] = left >> 8;
+    TXRINGBUF[iptr++] = left;
+    TXRINGBUF[iptr++] = right >> 8;
+    TXRINGBUF[iptr++] = right;
+  }
+
+  if (device == DEVICE_HERMES_LITE2) {
+    //
+    // The "CWX" method in the HL2 firmware behaves erroneously
+    // if the CW input from the KEY/PTT jack is activated.
+    // To make piHPSDR immune to this problem, the least significant
+    // bit of the I (and Q) samples are cleared.
+    // The resolution of the IQ samples is thus reduced from 16 to 15 bits,
+    // but since the HL2 DAC is 12-bit this is no problem.
+    //
+    TXRINGBUF[iptr++] = isample >> 8;
+    TXRINGBUF[iptr++] = isample & 0xFE;
+    TXRINGBUF[iptr++] = qsample >> 8;
+    TXRINGBUF[iptr++] = qsample & 0xFE;
+  } else {
+    TXRINGBUF[iptr++] = isample >> 8;
+    TXRINGBUF[iptr++] = isample;
+    TXRINGBUF[iptr++] = qsample >> 8;
+    TXRINGBUF[iptr++] = qsample;
+  }
+
+  txring_count++;
+
+  if (txring_count >= 126) {
+    int nptr = txring_inptr + 1008;
+
+    if (nptr >= TXRINGBUFLEN) { nptr = 0; }
+
+    if (nptr != txring_outptr) {
+#ifdef __APPLE__
+      sem_post(txring_sem);
+#else
+      sem_post(&txring_sem);
+#endif
+      txring_inptr = nptr;
+      txring_count = 0;
+    } else {
+      t_print("%s: output buffer overflow.\n", __FUNCTION__);
+      txring_count = -1260;
     }
+  }
+}
+
+//
+// Queue a block of n RX audio samples (interleaved L/R) for the radio.
+// The TX ring buffer is locked only once for the whole block.
+//
+void old_protocol_audio_block(const short *samples, int n) {
+  if (!isTransmitting()) {
+    pthread_mutex_lock(&send_audio_mutex);
 
     if (txring_flag) {
       //
@@ -1701,65 +2055,23 @@ void old_protocol_audio_samples(short left_audio_sample, short right_audio_sampl
       txring_flag = 0;
     }
 
-    int iptr = txring_inptr + 8 * txring_count;
-
-    //
-    // The HL2 makes no use of audio samples, but instead
-    // uses them to write to extended addrs which we do not
-    // want to do un-intentionally, therefore send zeros.
-    // Note special variants of the HL2 *do* have an audio codec!
-    //
-    if (device == DEVICE_HERMES_LITE2 && !hl2_audio_codec) {
-      TXRINGBUF[iptr++] = 0;
-      TXRINGBUF[iptr++] = 0;
-      TXRINGBUF[iptr++] = 0;
-      TXRINGBUF[iptr++] = 0;
-    } else {
-      TXRINGBUF[iptr++] = left_audio_sample >> 8;
-      TXRINGBUF[iptr++] = left_audio_sample;
-      TXRINGBUF[iptr++] = right_audio_sample >> 8;
-      TXRINGBUF[iptr++] = right_audio_sample;
-    }
-
-    TXRINGBUF[iptr++] = 0;
-    TXRINGBUF[iptr++] = 0;
-    TXRINGBUF[iptr++] = 0;
-    TXRINGBUF[iptr++] = 0;
-    txring_count++;
-
-    if (txring_count >= 126) {
-      int nptr = txring_inptr + 1008;
-
-      if (nptr >= TXRINGBUFLEN) { nptr = 0; }
-
-      if (nptr != txring_outptr) {
-#ifdef __APPLE__
-        sem_post(txring_sem);
-#else
-        sem_post(&txring_sem);
-#endif
-        txring_inptr = nptr;
-        txring_count = 0;
-      } else {
-        t_print("%s: output buffer overflow.\n", __FUNCTION__);
-        txring_count = -1260;
-      }
+    for (int i = 0; i < n; i++) {
+      txring_put_sample(samples[2 * i], samples[2 * i + 1], 0, 0);
     }
 
     pthread_mutex_unlock(&send_audio_mutex);
   }
 }
 
-void old_protocol_iq_samples(int isample, int qsample, int side) {
+//
+// Queue a block of n TX IQ samples (interleaved I/Q) for the radio,
+// together with the CW side tone (side may be NULL if there is none).
+// The TX ring buffer is locked only once for the whole block.
+//
+void old_protocol_iq_block(const int *iq, const int *side, int n) {
   if (isTransmitting()) {
     pthread_mutex_lock(&send_audio_mutex);
 
-    if (txring_count < 0) {
-      txring_count++;
-      pthread_mutex_unlock(&send_audio_mutex);
-      return;
-    }
-
     if (!txring_flag) {
       //
       // First time we arrive here after a RX->TX transition:
@@ -1773,65 +2085,9 @@ void old_protocol_iq_samples(int isample, int qsample, int side) {
       txring_flag = 1;
     }
 
-    int iptr = txring_inptr + 8 * txring_count;
-
-    //
-    // The HL2 makes no use of audio samples, but instead
-    // uses them to write to extended addrs which we do not
-    // want to do un-intentionally, therefore send zeros.
-    // Note special variants of the HL2 *do* have an audio codec!
-    //
-    if (device == DEVICE_HERMES_LITE2 && !hl2_audio_codec) {
-      TXRINGBUF[iptr++] = 0;
-      TXRINGBUF[iptr++] = 0;
-      TXRINGBUF[iptr++] = 0;
-      TXRINGBUF[iptr++] = 0;
-    } else {
-      TXRINGBUF[iptr++] = side  >> 8;
-      TXRINGBUF[iptr++] = side;
-      TXRINGBUF[iptr++] = side >> 8;
-      TXRINGBUF[iptr++] = side;
-    }
-
-    if (device == DEVICE_HERMES_LITE2) {
-      //
-      // The "CWX" method in the HL2 firmware behaves erroneously
-      // if the CW input from the KEY/PTT jack is activated.
-      // To make piHPSDR immune to this problem, the least significant
-      // bit of the I (and Q) samples are cleared.
-      // The resolution of the IQ samples is thus reduced from 16 to 15 bits,
-      // but since the HL2 DAC is 12-bit this is no problem.
-      //
-      TXRINGBUF[iptr++] = isample >> 8;
-      TXRINGBUF[iptr++] = isample & 0xFE;
-      TXRINGBUF[iptr++] = qsample >> 8;
-      TXRINGBUF[iptr++] = qsample & 0xFE;
-    } else {
-      TXRINGBUF[iptr++] = isample >> 8;
-      TXRINGBUF[iptr++] = isample;
-      TXRINGBUF[iptr++] = qsample >> 8;
-      TXRINGBUF[iptr++] = qsample;
-    }
-
-    txring_count++;
-
-    if (txring_count >= 126) {
-      int nptr = txring_inptr + 1008;
-
-      if (nptr >= TXRINGBUFLEN) { nptr = 0; }
-
-      if (nptr != txring_outptr) {
-#ifdef __APPLE__
-        sem_post(txring_sem);
-#else
-        sem_post(&txring_sem);
-#endif
-        txring_inptr = nptr;
-        txring_count = 0;
-      } else {
-        t_print("%s: output buffer overflow.\n", __FUNCTION__);
-        txring_count = -1260;
-      }
+    for (int i = 0; i < n; i++) {
+      int sidetone = side ? side[i] : 0;
+      txring_put_sample(sidetone, sidetone, iq[2 * i], iq[2 * i + 1]);
     }
 
     pthread_mutex_unlock(&send_audio_mutex);
@@ -2861,10 +3117,9 @@ static void metis_restart() {
   // Note we send 504 audio samples = 8 OZY buffers =  4 METIS buffers
   //
   command = 1;
-
-  for (i = 0; i < 504; i++) {
-    old_protocol_audio_samples(0, 0);
-  }
+  short silence[2 * 504];
+  memset(silence, 0, sizeof(silence));
+  old_protocol_audio_block(silence, 504);
 
   sleep_ms(100);
 
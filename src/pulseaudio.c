@@ -28,6 +28,7 @@
 #include "mode.h"
 #include "vfo.h"
 #include "message.h"
+#include "rtsched.h"
 
 //
 // Used fixed buffer sizes.
@@ -187,6 +188,7 @@ int audio_open_output(RECEIVER *rx) {
 
 static void *mic_read_thread(gpointer arg) {
   int err;
+  rtsched_default();
   t_print("%s: running=%d\n", __FUNCTION__, running);
 
   while (running) {
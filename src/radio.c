@@ -85,6 +85,8 @@
   #include "client_server.h"
 #endif
 #include "message.h"
+#include "rtsched.h"
+#include "seqstat.h"
 #ifdef SATURN
   #include "saturnmain.h"
   #include "saturnserver.h"
@@ -173,6 +175,8 @@ int adc0_filter_bypass = 0; // Bypass ADC0 filters on receive
 int adc1_filter_bypass = 0; // Bypass ADC1 filters on receiver  (ANAN-7000/8000/G2)
 int mute_spkr_amp = 0;      // Mute audio amplifier in radio    (ANAN-7000, G2)
 
+int p2_ddc_sockets = 0;     // P2: one socket per DDC, read by the DDC threads (needs restart)
+
 int classE = 0;
 
 int tx_out_of_band_allowed = 0;
@@ -1468,6 +1472,7 @@ void start_radio() {
 
   receivers = RECEIVERS;
   radioRestoreState();
+  rtsched_start();
   radio_change_region(region);
   create_visual();
   reconfigure_screen();
@@ -2522,6 +2527,7 @@ void radioRestoreState() {
   GetPropI0("rigctl_start_with_autoreporting",               rigctl_start_with_autoreporting);
   GetPropI0("rigctl_port_base",                              rigctl_port);
   GetPropI0("mute_spkr_amp",                                 mute_spkr_amp);
+  GetPropI0("p2_ddc_sockets",                                p2_ddc_sockets);
   GetPropI0("adc0_filter_bypass",                            adc0_filter_bypass);
   GetPropI0("adc1_filter_bypass",                            adc1_filter_bypass);
 #ifdef SATURN
@@ -2578,6 +2584,8 @@ void radioRestoreState() {
   bandRestoreState();
   memRestoreState();
   vfoRestoreState();
+  rtschedRestoreState();
+  seqstatRestoreState();
   gpioRestoreActions();
 #ifdef MIDI
   midiRestoreState();
@@ -2731,6 +2739,7 @@ void radioSaveState() {
   SetPropI0("rigctl_start_with_autoreporting",               rigctl_start_with_autoreporting);
   SetPropI0("rigctl_port_base",                              rigctl_port);
   SetPropI0("mute_spkr_amp",                                 mute_spkr_amp);
+  SetPropI0("p2_ddc_sockets",                                p2_ddc_sockets);
   SetPropI0("adc0_filter_bypass",                            adc0_filter_bypass);
   SetPropI0("adc1_filter_bypass",                            adc1_filter_bypass);
 #ifdef SATURN
@@ -2781,6 +2790,8 @@ void radioSaveState() {
   bandSaveState();
   memSaveState();
   vfoSaveState();
+  rtschedSaveState();
+  seqstatSaveState();
   gpioSaveActions();
 #ifdef MIDI
   midiSaveState();
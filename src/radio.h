@@ -270,6 +270,8 @@ extern int adc0_filter_bypass;   // Bypass ADC0 filters on receive
 extern int adc1_filter_bypass;   // Bypass ADC1 filters on receiver  (ANAN-7000/8000/G2)
 extern int mute_spkr_amp;        // Mute audio amplifier in radio    (ANAN-7000, G2)
 
+extern int p2_ddc_sockets;       // P2: one socket per DDC, read by the DDC threads (needs restart)
+
 extern int VFO_WIDTH;
 extern int VFO_HEIGHT;
 extern int METER_WIDTH;
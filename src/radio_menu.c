@@ -861,6 +861,15 @@ void radio_menu(GtkWidget *parent) {
     g_signal_connect(ChkBtn, "toggled", G_CALLBACK(toggle_cb), &enable_auto_tune);
   }
 
+  if (protocol == NEW_PROTOCOL && !have_saturn_xdma) {
+    row++;
+    ChkBtn = gtk_check_button_new_with_label("Per-DDC sockets (needs restart)");
+    gtk_widget_set_name(ChkBtn, "boldlabel");
+    gtk_check_button_set_active (GTK_CHECK_BUTTON (ChkBtn), p2_ddc_sockets);
+    gtk_grid_attach(GTK_GRID(grid), ChkBtn, 0, row, 2, 1);
+    g_signal_connect(ChkBtn, "toggled", G_CALLBACK(toggle_cb), &p2_ddc_sockets);
+  }
+
   row++;
   // cppcheck-suppress redundantAssignment
   col = 0;
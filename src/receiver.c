@@ -454,7 +454,9 @@ static int update_display(gpointer data) {
         int b  = vfo[id].band;
         const BAND *band = band_get_band(b);
         int calib = rx_gain_calibration - band->gain;
-        double level = GetRXAMeter(rx->id, smeter);
+        double meters[RXA_METERTYPE_LAST];
+        GetRXAMeters(rx->id, meters);
+        double level = meters[smeter];
         level += (double)calib + (double)adc[rx->adc].attenuation - adc[rx->adc].gain;
 
         if (filter_board == CHARLY25 && rx->adc == 0) {
@@ -1328,6 +1330,12 @@ static void process_rx_buffer(RECEIVER *rx) {
   double left_sample, right_sample;
   short left_audio_sample, right_audio_sample;
   int i;
+  //
+  // Audio samples going to the radio are collected here and
+  // then sent in one shot (P1 only)
+  //
+  short radio_audio[2 * rx->output_samples];
+  int radio_samples = 0;
 
   //t_print("%s: rx=%p id=%d output_samples=%d audio_output_buffer=%p\n",__FUNCTION__,rx,rx->id,rx->output_samples,rx->audio_output_buffer);
 
@@ -1446,11 +1454,14 @@ static void process_rx_buffer(RECEIVER *rx) {
       switch (protocol) {
       case ORIGINAL_PROTOCOL:
         if (rx->mute_radio) {
-          old_protocol_audio_samples((short)0, (short)0);
+          radio_audio[2 * radio_samples] = 0;
+          radio_audio[2 * radio_samples + 1] = 0;
         } else {
-          old_protocol_audio_samples(left_audio_sample, right_audio_sample);
+          radio_audio[2 * radio_samples] = left_audio_sample;
+          radio_audio[2 * radio_samples + 1] = right_audio_sample;
         }
 
+        radio_samples++;
         break;
 
       case NEW_PROTOCOL:
@@ -1467,6 +1478,29 @@ static void process_rx_buffer(RECEIVER *rx) {
       }
     }
   }
+
+  if (radio_samples > 0) {
+    old_protocol_audio_block(radio_audio, radio_samples);
+  }
+}
+
+//
+// The incoming samples are written directly into the WDSP input
+// ring (fexchange_acquire), which saves copying the whole buffer
+// in fexchange0(). If the channel is not running, WDSP hands out
+// no span and the samples go to iq_input_buffer as before.
+// A new target is chosen when a buffer begins to fill.
+//
+static double *rx_iq_input(RECEIVER *rx) {
+  if (rx->samples == 0) {
+    rx->iq_input = fexchange_acquire(rx->id);
+
+    if (rx->iq_input == NULL) {
+      rx->iq_input = rx->iq_input_buffer;
+    }
+  }
+
+  return rx->iq_input;
 }
 
 void full_rx_buffer(RECEIVER *rx) {
@@ -1481,13 +1515,15 @@ void full_rx_buffer(RECEIVER *rx) {
     //
     // noise blanker works on original IQ samples with input sample rate
     //
+    double *iq = rx->iq_input;
+
     switch (rx->nb) {
     case 1:
-      xanbEXT (rx->id, rx->iq_input_buffer, rx->iq_input_buffer);
+      xanbEXT (rx->id, iq, iq);
       break;
 
     case 2:
-      xnobEXT (rx->id, rx->iq_input_buffer, rx->iq_input_buffer);
+      xnobEXT (rx->id, iq, iq);
       break;
 
     default:
@@ -1495,7 +1531,11 @@ void full_rx_buffer(RECEIVER *rx) {
       break;
     }
 
-    fexchange0(rx->id, rx->iq_input_buffer, rx->audio_output_buffer, &error);
+    if (iq == rx->iq_input_buffer) {
+      fexchange0(rx->id, iq, rx->audio_output_buffer, &error);
+    } else {
+      fexchange_commit(rx->id, rx->audio_output_buffer, &error);
+    }
 
     if (error != 0) {
       t_print("%s: id=%d fexchange0: error=%d\n", __FUNCTION__, rx->id, error);
@@ -1503,7 +1543,7 @@ void full_rx_buffer(RECEIVER *rx) {
 
     if (rx->displaying) {
       g_mutex_lock(&rx->display_mutex);
-      Spectrum0(1, rx->id, 0, 0, rx->iq_input_buffer);
+      Spectrum0(1, rx->id, 0, 0, iq);
       g_mutex_unlock(&rx->display_mutex);
     }
 
@@ -1530,8 +1570,9 @@ void add_iq_samples(RECEIVER *rx, double i_sample, double q_sample) {
     rx->txrxcount++;
   }
 
-  rx->iq_input_buffer[rx->samples * 2] = i_sample;
-  rx->iq_input_buffer[(rx->samples * 2) + 1] = q_sample;
+  double *iq = rx_iq_input(rx);
+  iq[rx->samples * 2] = i_sample;
+  iq[(rx->samples * 2) + 1] = q_sample;
   rx->samples = rx->samples + 1;
 
   if (rx->samples >= rx->buffer_size) {
@@ -1550,6 +1591,85 @@ void add_div_iq_samples(RECEIVER *rx, double i0, double q0, double i1, double q1
   add_iq_samples(rx, i_sample, q_sample);
 }
 
+//
+// Block versions of add_iq_samples: iq contains n interleaved I/Q pairs.
+// The samples are copied span by span up to the end of the RX buffer,
+// the TX/RX "silencing" is applied to the beginning of a span, and
+// full_rx_buffer() is called whenever the RX buffer is complete.
+// The result is the same as calling add_iq_samples() n times.
+//
+static int add_iq_span_start(RECEIVER *rx, double *dst, int n, int *mute) {
+  int k = rx->buffer_size - rx->samples;
+  int m = rx->txrxmax - rx->txrxcount;
+
+  if (k > n) { k = n; }
+
+  if (m > k) { m = k; }
+
+  if (m > 0) {
+    memset(dst, 0, 2 * m * sizeof(double));
+    rx->txrxcount += m;
+  } else {
+    m = 0;
+  }
+
+  *mute = m;
+  return k;
+}
+
+static void add_iq_span_done(RECEIVER *rx, int k) {
+  rx->samples += k;
+
+  if (rx->samples >= rx->buffer_size) {
+    full_rx_buffer(rx);
+    rx->samples = 0;
+  }
+}
+
+void add_iq_samples_block(RECEIVER *rx, const float *iq, int n) {
+  while (n > 0) {
+    int mute;
+    double *dst = rx_iq_input(rx) + 2 * rx->samples;
+    int k = add_iq_span_start(rx, dst, n, &mute);
+
+    for (int i = 2 * mute; i < 2 * k; i++) {
+      dst[i] = (double) iq[i];
+    }
+
+    add_iq_span_done(rx, k);
+    iq += 2 * k;
+    n -= k;
+  }
+}
+
+void add_iq_samples_block_double(RECEIVER *rx, const double *iq, int n) {
+  while (n > 0) {
+    int mute;
+    double *dst = rx_iq_input(rx) + 2 * rx->samples;
+    int k = add_iq_span_start(rx, dst, n, &mute);
+    memcpy(dst + 2 * mute, iq + 2 * mute, 2 * (k - mute) * sizeof(double));
+    add_iq_span_done(rx, k);
+    iq += 2 * k;
+    n -= k;
+  }
+}
+
+//
+// Block version of add_div_iq_samples. The two channels are taken
+// from iq0 and iq1, where consecutive samples are "stride" doubles
+// apart (stride is 2 for plain I/Q arrays).
+//
+void add_div_iq_samples_block(RECEIVER *rx, const double *iq0, const double *iq1, int stride, int n) {
+  double iq[2 * n];
+
+  for (int i = 0; i < n; i++, iq0 += stride, iq1 += stride) {
+    iq[2 * i]     = iq0[0] + (div_cos * iq1[0] - div_sin * iq1[1]);
+    iq[2 * i + 1] = iq0[1] + (div_sin * iq1[0] + div_cos * iq1[1]);
+  }
+
+  add_iq_samples_block_double(rx, iq, n);
+}
+
 void receiver_update_zoom(RECEIVER *rx) {
   //
   // This is called whenever rx->zoom or rx->width changes,
@@ -65,6 +65,7 @@ typedef struct _receiver {
   int samples;
   int output_samples;
   double *iq_input_buffer;
+  double *iq_input;         // buffer being filled: a WDSP input span or iq_input_buffer
   double *audio_output_buffer;
   int audio_index;
   float *pixel_samples;
@@ -266,6 +267,9 @@ extern void set_offset(const RECEIVER *rx, long long offset);
 
 extern void add_iq_samples(RECEIVER *rx, double i_sample, double q_sample);
 extern void add_div_iq_samples(RECEIVER *rx, double i0, double q0, double i1, double q1);
+extern void add_iq_samples_block(RECEIVER *rx, const float *iq, int n);
+extern void add_iq_samples_block_double(RECEIVER *rx, const double *iq, int n);
+extern void add_div_iq_samples_block(RECEIVER *rx, const double *iq0, const double *iq1, int stride, int n);
 
 extern void reconfigure_receiver(RECEIVER *rx, int height);
 
@@ -65,6 +65,7 @@
 #include "exit_menu.h"
 #include "message.h"
 #include "mystring.h"
+#include "rtsched.h"
 
 #include <math.h>
 
@@ -563,6 +564,7 @@ static gpointer rigctl_cw_thread(gpointer data) {
   int  buffered_speed = 0;
   int  bracket_command = 0;
 
+  rtsched_default();
   while (server_running) {
     // wait for CW data (periodically look every 100 msec)
     if (cw_buf_in == cw_buf_out) {
@@ -855,6 +857,7 @@ gboolean auto_reporter(gpointer data) {
 static gpointer rigctl_server(gpointer data) {
   int port = GPOINTER_TO_INT(data);
   int on = 1;
+  rtsched_default();
   t_print("%s: starting TCP server on port %d\n", __FUNCTION__, port);
   server_socket = socket(AF_INET, SOCK_STREAM, 0);
 
@@ -960,6 +963,7 @@ static gpointer rigctl_server(gpointer data) {
 
 static gpointer rigctl_client (gpointer data) {
   CLIENT *client = (CLIENT *)data;
+  rtsched_default();
   t_print("%s: starting rigctl_client: socket=%d\n", __FUNCTION__, client->fd);
   g_mutex_lock(&mutex_a->m);
   cat_control++;
@@ -5584,6 +5588,7 @@ static gpointer serial_server(gpointer data) {
   int i;
   fd_set fds;
   struct timeval tv;
+  rtsched_default();
   t_print("%s: Entering Thread\n", __FUNCTION__);
   g_mutex_lock(&mutex_a->m);
   cat_control++;
@@ -0,0 +1,222 @@
+/* Copyright (C)
+* 2026 - the piHPSDR authors
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*
+*/
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+  #define _GNU_SOURCE  // for pthread_setaffinity_np()
+#endif
+
+#include <gtk/gtk.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <wdsp.h>
+
+#include "rtsched.h"
+#include "property.h"
+#include "message.h"
+
+THREAD_POLICY thread_policy[THREAD_ROLES] = {
+  { RTSCHED_NORMAL, 0, 0 },
+  { RTSCHED_NORMAL, 0, 0 },
+  { RTSCHED_NORMAL, 0, 0 },
+  { RTSCHED_NORMAL, 0, 0 }
+};
+
+static const char *role_name[THREAD_ROLES] = { "gui", "rx", "tx", "dsp" };
+
+//
+// warn only once per role, otherwise the log is flooded since
+// some threads are re-started upon each protocol restart
+//
+static int warned[THREAD_ROLES];
+
+static int sched_policy(int policy) {
+  switch (policy) {
+  case RTSCHED_FIFO:
+    return SCHED_FIFO;
+
+  case RTSCHED_RR:
+    return SCHED_RR;
+
+  default:
+    return SCHED_OTHER;
+  }
+}
+
+//
+// Clamp the priority to what the scheduling class supports
+//
+static int sched_priority(int policy, int priority) {
+  int min = sched_get_priority_min(policy);
+  int max = sched_get_priority_max(policy);
+
+  if (priority < min) { priority = min; }
+
+  if (priority > max) { priority = max; }
+
+  return priority;
+}
+
+//
+// The scheduling policy and CPU affinity the process was started with
+// (e.g. by taskset, chrt, systemd or a cpuset), taken once before any
+// thread is changed. "Normal" and "no CPU restriction" restore these.
+//
+static struct {
+  int valid;
+  int policy;
+  struct sched_param param;
+#ifdef __linux__
+  cpu_set_t cpus;
+#endif
+} orig;
+
+static void snapshot_policy() {
+  if (orig.valid) { return; }
+
+  if (pthread_getschedparam(pthread_self(), &orig.policy, &orig.param) != 0) { return; }
+
+#ifdef SCHED_RESET_ON_FORK
+  orig.policy &= ~SCHED_RESET_ON_FORK;
+#endif
+#ifdef __linux__
+
+  if (sched_getaffinity(0, sizeof(orig.cpus), &orig.cpus) != 0) { return; }
+
+#endif
+  orig.valid = 1;
+}
+
+//
+// Apply a policy to the calling thread. "Normal" and "no CPU restriction"
+// are applied as well (restoring the original settings, see above): threads
+// inherit the scheduling class and the CPU affinity of the thread creating
+// them, which is mostly the GUI thread.
+// role < 0 is used for threads that have no role of their own.
+//
+static void apply_policy(const THREAD_POLICY *p, int role) {
+  static const THREAD_POLICY normal = { RTSCHED_NORMAL, 0, 0 };
+  struct sched_param param;
+  int policy, rc;
+
+  if (p == NULL) { p = &normal; }
+
+  if (p->policy != RTSCHED_NORMAL) {
+    policy = sched_policy(p->policy);
+    param.sched_priority = sched_priority(policy, p->priority);
+#ifdef SCHED_RESET_ON_FORK
+
+    //
+    // Threads created by the GUI thread must not inherit a real-time class
+    //
+    if (role == THREAD_ROLE_GUI) { policy |= SCHED_RESET_ON_FORK; }
+
+#endif
+    rc = pthread_setschedparam(pthread_self(), policy, &param);
+  } else if (orig.valid) {
+    rc = pthread_setschedparam(pthread_self(), orig.policy, &orig.param);
+  } else {
+    rc = 0;
+  }
+
+  if (rc != 0 && role >= 0 && !warned[role]) {
+    t_print("%s: WARNING: cannot set real-time scheduling for %s threads (%s), using default\n",
+            __FUNCTION__, role_name[role], strerror(rc));
+    warned[role] = 1;
+  }
+
+#ifdef __linux__
+
+  if (p->cpus != 0) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    for (int i = 0; i < 32; i++) {
+      if (p->cpus & (1U << i)) { CPU_SET(i, &set); }
+    }
+
+    rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  } else if (orig.valid) {
+    rc = pthread_setaffinity_np(pthread_self(), sizeof(orig.cpus), &orig.cpus);
+  } else {
+    rc = 0;
+  }
+
+  if (rc != 0 && role >= 0 && !warned[role]) {
+    t_print("%s: WARNING: cannot pin %s threads to CPU mask 0x%x (%s)\n",
+            __FUNCTION__, role_name[role], p->cpus, strerror(rc));
+    warned[role] = 1;
+  }
+
+#else
+
+  if (p->cpus != 0 && role >= 0 && !warned[role]) {
+    t_print("%s: WARNING: CPU pinning not supported on this platform\n", __FUNCTION__);
+    warned[role] = 1;
+  }
+
+#endif
+}
+
+//
+// Apply the policy of a role to the calling thread.
+//
+void rtsched_apply(int role) {
+  if (role < 0 || role >= THREAD_ROLES) { return; }
+
+  apply_policy(&thread_policy[role], role);
+}
+
+//
+// Original scheduling and CPU affinity for the calling thread. This is
+// called by long-running threads without a role (audio, rigctl, ...), so
+// they do not run with the settings of the GUI thread that created them.
+//
+void rtsched_default() {
+  apply_policy(NULL, -1);
+}
+
+//
+// Called once from the GTK main thread after the props file has been
+// read, and before any WDSP channel is opened.
+//
+void rtsched_start() {
+  snapshot_policy();
+  rtsched_apply(THREAD_ROLE_GUI);
+#ifndef _WIN32
+  const THREAD_POLICY *p = &thread_policy[THREAD_ROLE_DSP];
+  int policy = sched_policy(p->policy);
+  WDSPSetThreadPolicy(policy, sched_priority(policy, p->priority), p->cpus);
+#endif
+}
+
+void rtschedSaveState() {
+  for (int i = 0; i < THREAD_ROLES; i++) {
+    SetPropI1("rtsched.%s.policy", role_name[i],             thread_policy[i].policy);
+    SetPropI1("rtsched.%s.priority", role_name[i],           thread_policy[i].priority);
+    SetPropI1("rtsched.%s.cpus", role_name[i],               thread_policy[i].cpus);
+  }
+}
+
+void rtschedRestoreState() {
+  for (int i = 0; i < THREAD_ROLES; i++) {
+    GetPropI1("rtsched.%s.policy", role_name[i],             thread_policy[i].policy);
+    GetPropI1("rtsched.%s.priority", role_name[i],           thread_policy[i].priority);
+    GetPropI1("rtsched.%s.cpus", role_name[i],               thread_policy[i].cpus);
+  }
+}
@@ -0,0 +1,74 @@
+/* Copyright (C)
+* 2026 - the piHPSDR authors
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*
+*/
+
+//
+// Thread placement policy.
+//
+// Each thread has a "role", and for each role one can choose the
+// scheduling class (normal, real-time FIFO or real-time round-robin),
+// the real-time priority, and a set of CPUs the threads are pinned to.
+// The settings are stored in the props file, e.g.
+//
+// rtsched.rx.policy=1     (0: normal, 1: SCHED_FIFO, 2: SCHED_RR)
+// rtsched.rx.priority=60  (1 ... 99, only used for real-time classes)
+// rtsched.rx.cpus=4       (bit mask, 0: no restriction, 4 = CPU2 only)
+//
+// The default is normal scheduling without pinning for all roles.
+// "Normal" and "no restriction" mean the scheduling class and CPU set
+// the process was started with (e.g. by taskset, chrt or a cpuset).
+// This is also enforced: a thread of a role with the default settings
+// gets these back, even if it was created by a real-time or pinned
+// thread. Threads without a role call rtsched_default() for the same
+// purpose, and WDSP creates its threads with these settings.
+// Real-time scheduling requires CAP_SYS_NICE (or an rtprio limit);
+// if the process lacks this, a warning is logged and the thread
+// continues with default scheduling.
+//
+
+#ifndef _RTSCHED_H_
+#define _RTSCHED_H_
+
+enum _thread_role {
+  THREAD_ROLE_GUI = 0,   // the GTK main thread
+  THREAD_ROLE_RX,        // threads receiving data from the radio (P1, P2, SoapySDR, Saturn)
+  THREAD_ROLE_TX,        // threads sending data to the radio, and the CW keyer
+  THREAD_ROLE_DSP,       // the WDSP channel threads
+  THREAD_ROLES
+};
+
+enum _rtsched_policy {
+  RTSCHED_NORMAL = 0,
+  RTSCHED_FIFO,
+  RTSCHED_RR
+};
+
+typedef struct _thread_policy {
+  int policy;
+  int priority;
+  unsigned int cpus;
+} THREAD_POLICY;
+
+extern THREAD_POLICY thread_policy[THREAD_ROLES];
+
+extern void rtsched_apply(int role);
+extern void rtsched_default(void);
+extern void rtsched_start(void);
+extern void rtschedSaveState(void);
+extern void rtschedRestoreState(void);
+
+#endif
@@ -59,6 +59,7 @@
 #include "discovered.h"
 #include "new_protocol.h"
 #include "message.h"
+#include "rtsched.h"
 #include "mystring.h"
 
 extern sem_t DDCInSelMutex;                 // protect access to shared DDC input select register
@@ -134,97 +135,35 @@ unsigned char*
 IQBasePtr[VNUMDDC];                                                      // ptr to DMA location in I/Q memory
 
 // Memory buffers to be exchanged with PiHPSDR APIs
-#define MAXMYBUF 3
-#define DDCMYBUF 0
-#define MICMYBUF 1
-#define HPMYBUF  2
+// (see bufpool.h). The pool sizes are derived from the ring buffers
+// in new_protocol.c, which bound the number of buffers in flight.
 //
-// number of buffers allocated (for statistics)
-//
-static int num_buf[MAXMYBUF];
+static BUFPOOL *ddc_pool = NULL;
+static BUFPOOL *mic_pool = NULL;
+static BUFPOOL *hp_pool = NULL;
 
 //
-// head of buffer list
-//
-static mybuffer *buflist[MAXMYBUF];
-
+// Obtain a free buffer. Each pool is only drawn from by a single
+// thread. Should a pool run dry (consumer threads stuck), wait until
+// a buffer comes back rather than growing the pool.
 //
-// Obtain a free buffer. If no one is available allocate
-// new ones. Note these buffer "live" as long as the
-// program lives. They are never released.
-//
-static mybuffer *get_my_buffer(int numlist) {
-  int i, j, first;
-  const char *desc;
-  mybuffer *bp = buflist[numlist];
-
-  while (bp) {
-    if (bp->free) {
-      // found free buffer. Mark as used and return that one.
-      bp->free = 0;
-      return bp;
-    }
+static mybuffer *get_my_buffer(BUFPOOL *pool) {
+  mybuffer *bp;
 
-    bp = bp->next;
+  while ((bp = bufpool_get(pool)) == NULL) {
+    usleep(500);
   }
 
-  //
-  // No buffer free, or the first time we request a buffer:
-  // allocate (a) new one(s). Note we need very few
-  // HighPrio buffers, a limited amount of MicSample buffers,
-  // and a possibly large amount of DDC IQ buffers.
-  //
-  first = (bp == NULL);
-
-  switch (numlist) {
-  case HPMYBUF:
-    j = 1;
-    desc = "HP";
-    break;
-
-  case MICMYBUF:
-    j = 5;
-    desc = "MIC";
-    break;
-
-  case DDCMYBUF:
-    j = 25;
-    desc = "DDC";
-    break;
-
-  default:
-    // NOTREACHED
-    j = 5;
-    desc = "UNKNOWN";
-    break;
-  }
-
-  for (i = 0; i < j; i++) {
-    bp = malloc(sizeof(mybuffer));
-    bp->free = 1;
-    bp->next = buflist[numlist];
-    buflist[numlist] = bp;
-    num_buf[numlist]++;
-  }
-
-  t_print("%s: number of buffer[%s] %s to %d\n", __FUNCTION__, desc,
-          first ? "set" : "increased", num_buf[numlist]);
-  // Mark the first buffer in list as used and return that one.
-  buflist[numlist]->free = 0;
-  return buflist[numlist];
+  return bp;
 }
 
 void saturn_free_buffers() {
-  mybuffer *mybuf;
-
-  for (int i = 0; i < MAXMYBUF; i++) {
-    mybuf = buflist[i];
-
-    while (mybuf) {
-      mybuf->free = 1;
-      mybuf = mybuf->next;
-    }
-  }
+  bufpool_stats(ddc_pool);
+  bufpool_stats(mic_pool);
+  bufpool_stats(hp_pool);
+  bufpool_release_all(ddc_pool);
+  bufpool_release_all(mic_pool);
+  bufpool_release_all(hp_pool);
 }
 
 bool CreateDynamicMemory(void) {                            // return true if error
@@ -662,6 +601,7 @@ static gpointer saturn_high_priority_thread(gpointer arg) {
   struct sockaddr_in DestAddr;
   struct iovec iovecinst;
   struct msghdr datagram;
+  rtsched_apply(THREAD_ROLE_RX);
 
   while (!Exiting) {
     uint32_t SequenceCounter = 0;                       // sequence count
@@ -694,7 +634,7 @@ static gpointer saturn_high_priority_thread(gpointer arg) {
     while (SDRActive) {                            // main loop
       uint16_t SleepCount;                                      // counter for sending next message
       uint8_t PTTBits;                                          // PTT bits - and change means a new message needed
-      mybuffer *mybuf = get_my_buffer(HPMYBUF);
+      mybuffer *mybuf = get_my_buffer(hp_pool);
       ReadStatusRegister();
       PTTBits = (uint8_t)GetP2PTTKeyInputs();
       *(uint8_t *)(UDPBuffer + 4) = *(uint8_t *)(mybuf->buffer + 4) = PTTBits;
@@ -719,7 +659,7 @@ static gpointer saturn_high_priority_thread(gpointer arg) {
         *(uint32_t *)mybuf->buffer = htonl(SequenceCounter++);       // add sequence count
         saturn_post_high_priority(mybuf);
       } else {
-        mybuf->free = 1;
+        mybuffer_release(mybuf);
       }
 
       if (ServerActive) {
@@ -775,6 +715,7 @@ void start_saturn_micaudio_thread() {
 
 static gpointer saturn_micaudio_thread(gpointer arg) {
   t_print( "%s\n", __FUNCTION__);
+  rtsched_apply(THREAD_ROLE_RX);
   //
   // variables for DMA buffer
   //
@@ -888,7 +829,7 @@ static gpointer saturn_micaudio_thread(gpointer arg) {
 
       DMAReadFromFPGA(DMAReadfile_fd, MicBasePtr, VDMAMICTRANSFERSIZE, VADDRMICSTREAMREAD);
       // create the packet
-      mybuffer *mybuf = get_my_buffer(MICMYBUF);
+      mybuffer *mybuf = get_my_buffer(mic_pool);
       *(uint32_t*)mybuf->buffer = htonl(SequenceCounter++);        // add sequence count
 
       if (TXActive == 2) {
@@ -943,6 +884,7 @@ extern struct sockaddr_in reply_addr;
 
 static gpointer saturn_rx_thread(gpointer arg) {
   t_print( "%s\n", __FUNCTION__);
+  rtsched_apply(THREAD_ROLE_RX);
   //
   // memory buffers
   //
@@ -1053,7 +995,7 @@ static gpointer saturn_rx_thread(gpointer arg) {
       for (DDC = 0; DDC < VNUMDDC; DDC++) {
         while ((IQHeadPtr[DDC] - IQReadPtr[DDC]) > VIQBYTESPERFRAME) {
           //                    t_print("enough data for packet: DDC= %d\n", DDC);
-          mybuffer *mybuf = get_my_buffer(DDCMYBUF);
+          mybuffer *mybuf = get_my_buffer(ddc_pool);
           *(uint32_t*)mybuf->buffer = htonl(SequenceCounter[DDC]++);     // add sequence count
           memset(mybuf->buffer + 4, 0, 8);                               // clear the timestamp data
           *(uint16_t*)(mybuf->buffer + 12) = htons(24);                  // bits per sample
@@ -1080,7 +1022,7 @@ static gpointer saturn_rx_thread(gpointer arg) {
               SequenceCounter[DDC] = 0;
             }
 
-            mybuf->free = 1;
+            mybuffer_release(mybuf);
           } else {
             saturn_post_iq_data(DDC - 6, mybuf);
           }
@@ -1265,6 +1207,9 @@ static gpointer saturn_rx_thread(gpointer arg) {
 }
 
 void saturn_init() {
+  ddc_pool = bufpool_create("Saturn DDC", MAX_DDC * (RXIQRINGBUFLEN + 1) + 8);
+  mic_pool = bufpool_create("Saturn MIC", MICRINGBUFLEN + 4);
+  hp_pool = bufpool_create("Saturn HP", 4);
   saturn_init_speaker_audio();
   saturn_init_duc_iq();
   start_saturn_receive_thread();
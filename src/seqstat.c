@@ -0,0 +1,297 @@
+/* Copyright (C)
+* 2026 - the piHPSDR authors
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*
+*/
+
+
+#include <gtk/gtk.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "seqstat.h"
+#include "mystring.h"
+#include "property.h"
+#include "message.h"
+
+const int seqstat_window[SEQSTAT_WINDOWS] = { 1, 10, 60 };
+
+int seqstat_dump = 0;     // dump interval in seconds, 0: off
+
+static SEQSTAT *streams[SEQSTAT_MAX_STREAMS];
+static int num_streams = 0;
+static void (*dumps[SEQSTAT_MAX_DUMPS])(void);
+static int num_dumps = 0;
+static GMutex seqstat_mutex;
+static guint seqstat_timer_id = 0;
+static int seqstat_ticks = 0;
+
+//
+// Take a snapshot of the counters of each stream, and
+// log a summary if requested.
+//
+static gboolean seqstat_timer_cb(gpointer data) {
+  gint64 now = g_get_monotonic_time();
+  int dump;
+  g_mutex_lock(&seqstat_mutex);
+
+  for (int i = 0; i < num_streams; i++) {
+    SEQSTAT *s = streams[i];
+    SEQSTAT_SNAPSHOT *snap = &s->history[s->hist_ptr];
+    snap->time = now;
+    memcpy(&snap->c, &s->c, sizeof(SEQSTAT_COUNTERS));
+
+    if (++s->hist_ptr >= SEQSTAT_HISTORY) { s->hist_ptr = 0; }
+
+    if (s->hist_count < SEQSTAT_HISTORY) { s->hist_count++; }
+  }
+
+  g_mutex_unlock(&seqstat_mutex);
+  seqstat_ticks++;
+  dump = seqstat_dump;
+
+  if (dump > 0 && seqstat_ticks % dump == 0) {
+    SEQSTAT_REPORT report;
+
+    for (int i = 0; seqstat_query(i, &report) == 0; i++) {
+      if (report.total.received > 0) { seqstat_print(&report); }
+    }
+
+    for (int i = 0; i < num_dumps; i++) {
+      (*dumps[i])();
+    }
+  }
+
+  return G_SOURCE_CONTINUE;
+}
+
+//
+// Register a stream for periodic sampling. This is done once
+// when the protocol is initialized, the SEQSTAT must be static.
+// Registering a stream twice is harmless.
+//
+void seqstat_register(SEQSTAT *s, const char *name) {
+  g_mutex_lock(&seqstat_mutex);
+
+  for (int i = 0; i < num_streams; i++) {
+    if (streams[i] == s) {
+      g_mutex_unlock(&seqstat_mutex);
+      return;
+    }
+  }
+
+  if (num_streams >= SEQSTAT_MAX_STREAMS) {
+    g_mutex_unlock(&seqstat_mutex);
+    t_print("%s: too many streams, %s not registered\n", __FUNCTION__, name);
+    return;
+  }
+
+  memset(s, 0, sizeof(SEQSTAT));
+  STRLCPY(s->name, name, sizeof(s->name));
+  streams[num_streams++] = s;
+
+  if (seqstat_timer_id == 0) {
+    seqstat_timer_id = g_timeout_add(1000, seqstat_timer_cb, NULL);
+  }
+
+  g_mutex_unlock(&seqstat_mutex);
+}
+
+//
+// Register a function that logs additional statistics each time
+// the stream summaries are dumped. The function is called from the
+// GTK main thread. Registering a function twice is harmless.
+//
+void seqstat_register_dump(void (*fn)(void)) {
+  g_mutex_lock(&seqstat_mutex);
+
+  for (int i = 0; i < num_dumps; i++) {
+    if (dumps[i] == fn) {
+      g_mutex_unlock(&seqstat_mutex);
+      return;
+    }
+  }
+
+  if (num_dumps < SEQSTAT_MAX_DUMPS) {
+    dumps[num_dumps++] = fn;
+  }
+
+  g_mutex_unlock(&seqstat_mutex);
+}
+
+//
+// Forget the sequence number so the next packet is accepted
+// without counting anything, e.g. upon a protocol restart.
+// May be called from any thread.
+//
+void seqstat_resync(SEQSTAT *s) {
+  s->resync = 1;
+}
+
+//
+// Account for a packet with the given sequence number.
+// Returns the classification (SEQSTAT_OK etc.), so the caller
+// can still log sequence errors as before.
+//
+int seqstat_packet(SEQSTAT *s, uint32_t sequence) {
+  int32_t diff;
+  s->c.received++;
+
+  if (s->resync) {
+    s->resync = 0;
+    s->synced = 0;
+  }
+
+  if (!s->synced) {
+    s->synced = 1;
+    s->expected = sequence + 1;
+    s->seen = 1;
+    return SEQSTAT_OK;
+  }
+
+  diff = (int32_t)(sequence - s->expected);
+
+  if (diff == 0) {
+    s->expected = sequence + 1;
+    s->seen = (s->seen << 1) | 1;
+    return SEQSTAT_OK;
+  }
+
+  if (diff >= SEQSTAT_MAX_GAP || diff <= -SEQSTAT_MAX_GAP) {
+    s->c.resyncs++;
+    s->expected = sequence + 1;
+    s->seen = 1;
+    return SEQSTAT_RESYNC;
+  }
+
+  if (diff > 0) {
+    s->c.lost += diff;
+    s->expected = sequence + 1;
+    s->seen = diff < 63 ? (s->seen << (diff + 1)) | 1 : 1;
+    return SEQSTAT_GAP;
+  }
+
+  //
+  // A packet from the past: bit k of "seen" corresponds to it
+  //
+  int k = -diff - 1;
+
+  if (k < 64) {
+    uint64_t bit = (uint64_t) 1 << k;
+
+    if (s->seen & bit) {
+      s->c.duplicates++;
+      return SEQSTAT_DUPLICATE;
+    }
+
+    s->seen |= bit;
+  }
+
+  s->c.reordered++;
+
+  if (s->c.lost > 0) { s->c.lost--; }
+
+  return SEQSTAT_REORDERED;
+}
+
+static void seqstat_rate(SEQSTAT_RATES *r, const SEQSTAT_COUNTERS *now, const SEQSTAT_COUNTERS *then, double sec) {
+  r->received   = (now->received   - then->received)   / sec;
+  r->lost       = ((double) now->lost - (double) then->lost) / sec;
+  r->reordered  = (now->reordered  - then->reordered)  / sec;
+  r->duplicates = (now->duplicates - then->duplicates) / sec;
+  r->overflows  = (now->overflows  - then->overflows)  / sec;
+  r->skipped    = (now->skipped    - then->skipped)    / sec;
+}
+
+static void seqstat_report(const SEQSTAT *s, SEQSTAT_REPORT *report) {
+  gint64 now = g_get_monotonic_time();
+  memset(report, 0, sizeof(SEQSTAT_REPORT));
+  STRLCPY(report->name, s->name, sizeof(report->name));
+  memcpy(&report->total, &s->c, sizeof(SEQSTAT_COUNTERS));
+
+  for (int w = 0; w < SEQSTAT_WINDOWS; w++) {
+    //
+    // Use the snapshot taken seqstat_window[w] seconds ago, or the
+    // oldest one available if the stream has not been around that long.
+    //
+    int back = seqstat_window[w];
+
+    if (back > s->hist_count) { back = s->hist_count; }
+
+    if (back == 0) { continue; }
+
+    int i = (s->hist_ptr - back + SEQSTAT_HISTORY) % SEQSTAT_HISTORY;
+    const SEQSTAT_SNAPSHOT *snap = &s->history[i];
+    double sec = 1.0E-6 * (now - snap->time);
+
+    if (sec <= 0.0) { continue; }
+
+    report->window[w] = sec;
+    seqstat_rate(&report->rate[w], &report->total, &snap->c, sec);
+  }
+}
+
+//
+// Obtain the counters and rates of the stream with the given index.
+// Returns 0 on success and -1 if there is no such stream, so all
+// streams can be enumerated by counting up from zero.
+//
+int seqstat_query(int index, SEQSTAT_REPORT *report) {
+  int rc = -1;
+  g_mutex_lock(&seqstat_mutex);
+
+  if (index >= 0 && index < num_streams) {
+    seqstat_report(streams[index], report);
+    rc = 0;
+  }
+
+  g_mutex_unlock(&seqstat_mutex);
+  return rc;
+}
+
+//
+// Same as seqstat_query, but look up the stream by its name
+//
+int seqstat_lookup(const char *name, SEQSTAT_REPORT *report) {
+  int rc = -1;
+  g_mutex_lock(&seqstat_mutex);
+
+  for (int i = 0; i < num_streams; i++) {
+    if (!strcmp(streams[i]->name, name)) {
+      seqstat_report(streams[i], report);
+      rc = 0;
+      break;
+    }
+  }
+
+  g_mutex_unlock(&seqstat_mutex);
+  return rc;
+}
+
+void seqstat_print(const SEQSTAT_REPORT *report) {
+  const SEQSTAT_COUNTERS *c = &report->total;
+  const SEQSTAT_RATES *r = &report->rate[1];
+  t_print("%s: %s: rcvd=%lu (%.0f/s) lost=%lu (%.1f/s) reord=%lu dup=%lu ovfl=%lu skip=%lu (%.1f/s) resync=%lu\n",
+          __FUNCTION__, report->name, c->received, r->received, c->lost, r->lost, c->reordered,
+          c->duplicates, c->overflows, c->skipped, r->skipped, c->resyncs);
+}
+
+void seqstatSaveState() {
+  SetPropI0("seqstat.dump",                                  seqstat_dump);
+}
+
+void seqstatRestoreState() {
+  GetPropI0("seqstat.dump",                                  seqstat_dump);
+}
@@ -0,0 +1,140 @@
+/* Copyright (C)
+* 2026 - the piHPSDR authors
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*
+*/
+
+
+//
+// Sequence-number and loss accounting for the data streams coming
+// from the radio (P1 METIS frames, P2 DDC, high-priority and mic
+// packets).
+//
+// Each stream has a SEQSTAT record which is owned by the thread
+// receiving the packets; only that thread calls seqstat_packet(),
+// seqstat_overflow() and seqstat_skipped(), so the hot path needs
+// no locking. Other threads may read the counters at any time,
+// they may then be slightly inconsistent.
+//
+// Registered streams are sampled once per second by a GLib timer,
+// from which packet and loss rates over sliding windows of 1, 10 and
+// 60 seconds are derived. If seqstat_dump is non-zero, a one-line
+// summary per stream is logged every seqstat_dump seconds, followed by
+// the output of the functions registered with seqstat_register_dump()
+// (e.g. the P2 DDC timing telemetry).
+//
+// Classification of an incoming sequence number:
+//   - the expected one:           ok
+//   - ahead of the expected one:  the packets in between are counted as lost
+//   - behind, not yet seen:       reordered (and no longer counted as lost)
+//   - behind, already seen:       duplicate
+//   - far off in either direction: resync (e.g. radio restart)
+// Packets up to 64 behind are tracked in a bit map, anything further
+// behind cannot be told apart and counts as reordered.
+//
+
+#ifndef _SEQSTAT_H_
+#define _SEQSTAT_H_
+
+#include <stdint.h>
+
+#define SEQSTAT_HISTORY   61     // one-second snapshots for a 60-second window
+#define SEQSTAT_WINDOWS    3     // 1, 10, 60 seconds
+#define SEQSTAT_MAX_GAP    65536 // larger jumps are re-synchronizations
+#define SEQSTAT_MAX_STREAMS 16
+#define SEQSTAT_MAX_DUMPS   4
+
+enum _seqstat_result {
+  SEQSTAT_OK = 0,
+  SEQSTAT_GAP,
+  SEQSTAT_REORDERED,
+  SEQSTAT_DUPLICATE,
+  SEQSTAT_RESYNC
+};
+
+typedef struct _seqstat_counters {
+  unsigned long received;      // packets received
+  unsigned long lost;          // packets missing in the sequence
+  unsigned long reordered;     // packets arriving after a later one
+  unsigned long duplicates;    // packets received twice
+  unsigned long overflows;     // ring buffer overflow events
+  unsigned long skipped;       // packets dropped because of an overflow
+  unsigned long resyncs;       // sequence number jumps
+} SEQSTAT_COUNTERS;
+
+typedef struct _seqstat_rates {
+  double received;             // all rates are per second
+  double lost;
+  double reordered;
+  double duplicates;
+  double overflows;
+  double skipped;
+} SEQSTAT_RATES;
+
+typedef struct _seqstat_snapshot {
+  long long time;              // g_get_monotonic_time()
+  SEQSTAT_COUNTERS c;
+} SEQSTAT_SNAPSHOT;
+
+typedef struct _seqstat {
+  char name[16];
+  SEQSTAT_COUNTERS c;          // written only by the receiving thread
+  uint32_t expected;           // next sequence number expected
+  uint64_t seen;               // bit i: (expected-1-i) has been received
+  int synced;
+  volatile int resync;         // set by seqstat_resync(), handled by the receiver
+  //
+  // history, only accessed by seqstat.c under its mutex
+  //
+  SEQSTAT_SNAPSHOT history[SEQSTAT_HISTORY];
+  int hist_ptr;
+  int hist_count;
+} SEQSTAT;
+
+typedef struct _seqstat_report {
+  char name[16];
+  SEQSTAT_COUNTERS total;
+  SEQSTAT_RATES rate[SEQSTAT_WINDOWS];   // over the last 1, 10, 60 seconds
+  double window[SEQSTAT_WINDOWS];        // actual length of the windows (sec)
+} SEQSTAT_REPORT;
+
+extern const int seqstat_window[SEQSTAT_WINDOWS];
+extern int seqstat_dump;
+
+extern void seqstat_register(SEQSTAT *s, const char *name);
+extern void seqstat_register_dump(void (*fn)(void));
+extern void seqstat_resync(SEQSTAT *s);
+extern int  seqstat_packet(SEQSTAT *s, uint32_t sequence);
+extern int  seqstat_query(int index, SEQSTAT_REPORT *report);
+extern int  seqstat_lookup(const char *name, SEQSTAT_REPORT *report);
+extern void seqstat_print(const SEQSTAT_REPORT *report);
+extern void seqstatSaveState(void);
+extern void seqstatRestoreState(void);
+
+//
+// Ring buffer overflow: one overflow event, n packets dropped.
+// Packets dropped later as a consequence of the same overflow
+// (e.g. while "skipping" buffers) are counted with seqstat_skipped().
+//
+static inline void seqstat_overflow(SEQSTAT *s, int n) {
+  s->c.overflows++;
+  s->c.skipped += n;
+}
+
+static inline void seqstat_skipped(SEQSTAT *s, int n) {
+  s->c.skipped += n;
+}
+
+#endif
@@ -42,6 +42,7 @@
 #include "vfo.h"
 #include "ext.h"
 #include "message.h"
+#include "rtsched.h"
 
 #define MAX_CHANNELS 2
 static SoapySDRStream *rx_stream[MAX_CHANNELS];
@@ -333,8 +334,6 @@ void soapy_protocol_init(gboolean hf) {
 }
 
 static void *receive_thread(void *arg) {
-  double isample;
-  double qsample;
   int flags = 0;
   long long timeNs = 0;
   long timeoutUs = 100000L;
@@ -345,6 +344,7 @@ static void *receive_thread(void *arg) {
   float fsample;
   running = TRUE;
   t_print("soapy_protocol: receive_thread\n");
+  rtsched_apply(THREAD_ROLE_RX);
   size_t channel = rx->adc;
 
   while (running) {
@@ -356,63 +356,52 @@ static void *receive_thread(void *arg) {
       continue;
     }
 
-    for (i = 0; i < elements; i++) {
-      rx->buffer[i * 2] = (double)buffer[i * 2];
-      rx->buffer[(i * 2) + 1] = (double)buffer[(i * 2) + 1];
-    }
+    int samples;
 
     if (rx->resampler != NULL) {
-      int samples = xresample(rx->resampler);
+      for (i = 0; i < elements; i++) {
+        rx->buffer[i * 2] = (double)buffer[i * 2];
+        rx->buffer[(i * 2) + 1] = (double)buffer[(i * 2) + 1];
+      }
 
-      for (i = 0; i < samples; i++) {
-        isample = rx->resample_buffer[i * 2];
-        qsample = rx->resample_buffer[(i * 2) + 1];
+      samples = xresample(rx->resampler);
 
-        if (iqswap) {
-          add_iq_samples(rx, qsample, isample);
-        } else {
-          add_iq_samples(rx, isample, qsample);
-        }
-
-        if (can_transmit) {
-          mic_samples++;
-
-          if (mic_samples >= mic_sample_divisor) { // reduce to 48000
-            if (transmitter != NULL) {
-              fsample = transmitter->local_microphone ? audio_get_next_mic_sample() : 0.0F;
-            } else {
-              fsample = 0.0F;
-            }
-
-            add_mic_sample(transmitter, fsample);
-            mic_samples = 0;
-          }
+      if (iqswap) {
+        for (i = 0; i < samples; i++) {
+          double tmp = rx->resample_buffer[i * 2];
+          rx->resample_buffer[i * 2] = rx->resample_buffer[(i * 2) + 1];
+          rx->resample_buffer[(i * 2) + 1] = tmp;
         }
       }
+
+      add_iq_samples_block_double(rx, rx->resample_buffer, samples);
     } else {
-      for (i = 0; i < elements; i++) {
-        isample = rx->buffer[i * 2];
-        qsample = rx->buffer[(i * 2) + 1];
+      samples = elements;
 
-        if (iqswap) {
-          add_iq_samples(rx, qsample, isample);
-        } else {
-          add_iq_samples(rx, isample, qsample);
+      if (iqswap) {
+        for (i = 0; i < samples; i++) {
+          float tmp = buffer[i * 2];
+          buffer[i * 2] = buffer[(i * 2) + 1];
+          buffer[(i * 2) + 1] = tmp;
         }
+      }
 
-        if (can_transmit) {
-          mic_samples++;
+      add_iq_samples_block(rx, buffer, samples);
+    }
 
-          if (mic_samples >= mic_sample_divisor) { // reduce to 48000
-            if (transmitter != NULL) {
-              fsample = transmitter->local_microphone ? audio_get_next_mic_sample() : 0.0F;
-            } else {
-              fsample = 0.0F;
-            }
+    if (can_transmit) {
+      for (i = 0; i < samples; i++) {
+        mic_samples++;
 
-            add_mic_sample(transmitter, fsample);
-            mic_samples = 0;
+        if (mic_samples >= mic_sample_divisor) { // reduce to 48000
+          if (transmitter != NULL) {
+            fsample = transmitter->local_microphone ? audio_get_next_mic_sample() : 0.0F;
+          } else {
+            fsample = 0.0F;
           }
+
+          add_mic_sample(transmitter, fsample);
+          mic_samples = 0;
         }
       }
     }
@@ -406,7 +406,9 @@ static gboolean update_display(gpointer data) {
     }
 
     g_mutex_unlock(&tx->display_mutex);
-    tx->alc = GetTXAMeter(tx->id, alc);
+    double meters[TXA_METERTYPE_LAST];
+    GetTXAMeters(tx->id, meters);
+    tx->alc = meters[alc];
     double constant1;
     double constant2;
     double rconstant2;  // allow different C2 values for calculating fwd and ref power
@@ -1202,13 +1204,19 @@ static void full_tx_buffer(TRANSMITTER *tx) {
         if (vol == 0 && CAT_cw_is_active) { vol = 12; }
 
         double sidevol = 64.0 * vol; // between 0.0 and 8128.0
+        int iqblock[2 * tx->output_samples];
+        int sideblock[tx->output_samples];
 
         for (j = 0; j < tx->output_samples; j++) {
           double ramp = tx->cw_sig_rf[j];       // between 0.0 and 1.0
           isample = floor(gain * ramp + 0.5);   // always non-negative, isample is just the pulse envelope
           sidetone = sidevol * ramp * sine_generator(&p1radio, &p2radio, cw_keyer_sidetone_frequency);
-          old_protocol_iq_samples(isample, 0, sidetone);
+          iqblock[2 * j] = isample;
+          iqblock[2 * j + 1] = 0;
+          sideblock[j] = sidetone;
         }
+
+        old_protocol_iq_block(iqblock, sideblock, tx->output_samples);
       }
       break;
 
@@ -1249,7 +1257,10 @@ static void full_tx_buffer(TRANSMITTER *tx) {
     } else {
       //
       // Original code without pulse shaping and without side tone
+      // For P1, the samples are collected and then sent in one shot.
       //
+      int iqblock[2 * tx->output_samples];
+
       for (j = 0; j < tx->output_samples; j++) {
         double is, qs;
         is = tx->iq_output_buffer[j * 2];
@@ -1259,7 +1270,8 @@ static void full_tx_buffer(TRANSMITTER *tx) {
 
         switch (protocol) {
         case ORIGINAL_PROTOCOL:
-          old_protocol_iq_samples(isample, qsample, 0);
+          iqblock[2 * j] = isample;
+          iqblock[2 * j + 1] = qsample;
           break;
 
         case NEW_PROTOCOL:
@@ -1274,6 +1286,10 @@ static void full_tx_buffer(TRANSMITTER *tx) {
 #endif
         }
       }
+
+      if (protocol == ORIGINAL_PROTOCOL) {
+        old_protocol_iq_block(iqblock, NULL, tx->output_samples);
+      }
     }
   } else {   // isTransmitting()
     if (txflag == 1 && protocol == NEW_PROTOCOL) {
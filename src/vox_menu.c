@@ -33,6 +33,7 @@
 #include "ext.h"
 #include "message.h"
 #include "pihpsdr_win32.h"
+#include "rtsched.h"
 
 static GtkWidget *dialog = NULL;
 
@@ -83,6 +84,7 @@ static int level_update(void *data) {
 }
 
 static gpointer level_thread(gpointer arg) {
+  rtsched_default();
   while (run_level) {
     peak = vox_get_peak();
     g_idle_add(level_update, NULL);
@@ -63,7 +63,7 @@ struct _rxa
     double* midbuff;
     int mode;
     double meter[RXA_METERTYPE_LAST];
-    CRITICAL_SECTION* pmtupdate[RXA_METERTYPE_LAST];
+    long mtseq;                                     // meter sequence count, odd while meter[] is written
     struct
     {
         METER p;
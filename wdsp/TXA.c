@@ -86,7 +86,7 @@ void create_txa (int channel)
         0.100,                                      // averaging time constant
         0.100,                                      // peak decay time constant
         txa[channel].meter,                         // result vector
-        txa[channel].pmtupdate,                     // locks for meter access
+        &txa[channel].mtseq,                        // sequence count for meter access
         TXA_MIC_AV,                                 // index for average value
         TXA_MIC_PK,                                 // index for peak value
         -1,                                         // index for gain value
@@ -136,7 +136,7 @@ void create_txa (int channel)
         0.100,                                      // averaging time constant
         0.100,                                      // peak decay time constant
         txa[channel].meter,                         // result vector
-        txa[channel].pmtupdate,                     // locks for meter access
+        &txa[channel].mtseq,                        // sequence count for meter access
         TXA_EQ_AV,                                  // index for average value
         TXA_EQ_PK,                                  // index for peak value
         -1,                                         // index for gain value
@@ -189,7 +189,7 @@ void create_txa (int channel)
         0.100,                                      // averaging time constant
         0.100,                                      // peak decay time constant
         txa[channel].meter,                         // result vector
-        txa[channel].pmtupdate,                     // locks for meter access
+        &txa[channel].mtseq,                        // sequence count for meter access
         TXA_LVLR_AV,                                // index for average value
         TXA_LVLR_PK,                                // index for peak value
         TXA_LVLR_GAIN,                              // index for gain value
@@ -230,7 +230,7 @@ void create_txa (int channel)
         0.100,                                      // averaging time constant
         0.100,                                      // peak decay time constant
         txa[channel].meter,                         // result vector
-        txa[channel].pmtupdate,                     // locks for meter access
+        &txa[channel].mtseq,                        // sequence count for meter access
         TXA_CFC_AV,                                 // index for average value
         TXA_CFC_PK,                                 // index for peak value
         TXA_CFC_GAIN,                               // index for gain value
@@ -302,7 +302,7 @@ void create_txa (int channel)
         0.100,                                      // averaging time constant
         0.100,                                      // peak decay time constant
         txa[channel].meter,                         // result vector
-        txa[channel].pmtupdate,                     // locks for meter access
+        &txa[channel].mtseq,                        // sequence count for meter access
         TXA_COMP_AV,                                // index for average value
         TXA_COMP_PK,                                // index for peak value
         -1,                                         // index for gain value
@@ -385,7 +385,7 @@ void create_txa (int channel)
         0.100,                                      // averaging time constant
         0.100,                                      // peak decay time constant
         txa[channel].meter,                         // result vector
-        txa[channel].pmtupdate,                     // locks for meter access
+        &txa[channel].mtseq,                        // sequence count for meter access
         TXA_ALC_AV,                                 // index for average value
         TXA_ALC_PK,                                 // index for peak value
         TXA_ALC_GAIN,                               // index for gain value
@@ -468,7 +468,7 @@ void create_txa (int channel)
         0.100,                                      // averaging time constant
         0.100,                                      // peak decay time constant
         txa[channel].meter,                         // result vector
-        txa[channel].pmtupdate,                     // locks for meter access
+        &txa[channel].mtseq,                        // sequence count for meter access
         TXA_OUT_AV,                                 // index for average value
         TXA_OUT_PK,                                 // index for peak value
         -1,                                         // index for gain value
@@ -77,7 +77,7 @@ struct _txa
     double f_low;
     double f_high;
     double meter[TXA_METERTYPE_LAST];
-    CRITICAL_SECTION* pmtupdate[TXA_METERTYPE_LAST];
+    long mtseq;                                     // meter sequence count, odd while meter[] is written
     struct
     {
         METER p;
@@ -71,6 +71,7 @@ void destroy_amd(AMD a)
 
 void init_amd(AMD a)
 {
+    int i;
     //pll
     a->omega_min = TWOPI * a->fmin / a->sample_rate;
     a->omega_max = TWOPI * a->fmax / a->sample_rate;
@@ -104,6 +105,12 @@ void init_amd(AMD a)
     a->c1[4] = -0.988739372718090;
     a->c1[5] = -0.996959189310611;
     a->c1[6] = -0.999282492800792;
+
+    for (i = 0; i < STAGES; i++)
+    {
+        a->cf[i][0] = a->cf[i][2] = a->c0[i];
+        a->cf[i][1] = a->cf[i][3] = a->c1[i];
+    }
 }
 
 void flush_amd (AMD a)
@@ -122,6 +129,9 @@ void xamd (AMD a)
     double del_out;
     double ai, bi, aq, bq;
     double ai_ps, bi_ps, aq_ps, bq_ps;
+    double v[4], y;
+    double phs, omega, fil_out, dc, dc_insert;
+    double x1[STAGES + 1][4], x2[STAGES + 1][4];
     int j, k;
     if (a->run)
     {
@@ -147,10 +157,17 @@ void xamd (AMD a)
 
             case 1:     //Synchronous AM Demodulator with Sideband Separation
                 {
+                    // the loop state is kept in locals, the stores to out_buff could alias the struct
+                    phs = a->phs;
+                    omega = a->omega;
+                    fil_out = a->fil_out;
+                    dc = a->dc;
+                    dc_insert = a->dc_insert;
+                    memcpy (x1, a->x1, sizeof (x1));
+                    memcpy (x2, a->x2, sizeof (x2));
                     for (i = 0; i < a->buff_size; i++)
                     {
-                        vco[0] = cos(a->phs);
-                        vco[1] = sin(a->phs);
+                        fast_sincos(phs, &vco[1], &vco[0]);
 
                         ai = a->in_buff[2 * i + 0] * vco[0];
                         bi = a->in_buff[2 * i + 0] * vco[1];
@@ -159,33 +176,33 @@ void xamd (AMD a)
 
                         if (a->sbmode != 0)
                         {
-                            a->a[0] = a->dsI;
-                            a->b[0] = bi;
-                            a->c[0] = a->dsQ;
-                            a->d[0] = aq;
+                            // four chains of all-pass stages, y = c * (x - y[-2]) + x[-2]
+                            v[0] = a->dsI;
+                            v[1] = bi;
+                            v[2] = a->dsQ;
+                            v[3] = aq;
                             a->dsI = ai;
                             a->dsQ = bq;
 
                             for (j = 0; j < STAGES; j++)
                             {
-                                k = 3 * j;
-                                a->a[k + 3] = a->c0[j] * (a->a[k] - a->a[k + 5]) + a->a[k + 2];
-                                a->b[k + 3] = a->c1[j] * (a->b[k] - a->b[k + 5]) + a->b[k + 2];
-                                a->c[k + 3] = a->c0[j] * (a->c[k] - a->c[k + 5]) + a->c[k + 2];
-                                a->d[k + 3] = a->c1[j] * (a->d[k] - a->d[k + 5]) + a->d[k + 2];
+                                for (k = 0; k < 4; k++)
+                                {
+                                    y = a->cf[j][k] * (v[k] - x2[j + 1][k]) + x2[j][k];
+                                    x2[j][k] = x1[j][k];
+                                    x1[j][k] = v[k];
+                                    v[k] = y;
+                                }
                             }
-                            ai_ps = a->a[OUT_IDX];
-                            bi_ps = a->b[OUT_IDX];
-                            bq_ps = a->c[OUT_IDX];
-                            aq_ps = a->d[OUT_IDX];
-
-                            for (j = OUT_IDX + 2; j > 0; j--)
+                            for (k = 0; k < 4; k++)
                             {
-                                a->a[j] = a->a[j - 1];
-                                a->b[j] = a->b[j - 1];
-                                a->c[j] = a->c[j - 1];
-                                a->d[j] = a->d[j - 1];
+                                x2[STAGES][k] = x1[STAGES][k];
+                                x1[STAGES][k] = v[k];
                             }
+                            ai_ps = v[0];
+                            bi_ps = v[1];
+                            bq_ps = v[2];
+                            aq_ps = v[3];
                         }
 
                         corr[0] = +ai + bq;
@@ -212,24 +229,30 @@ void xamd (AMD a)
 
                         if (a->levelfade)
                         {
-                            a->dc = a->mtauR * a->dc + a->onem_mtauR * audio;
-                            a->dc_insert = a->mtauI * a->dc_insert + a->onem_mtauI * corr[0];
-                            audio += a->dc_insert - a->dc;
+                            dc = a->mtauR * dc + a->onem_mtauR * audio;
+                            dc_insert = a->mtauI * dc_insert + a->onem_mtauI * corr[0];
+                            audio += dc_insert - dc;
                         }
                         a->out_buff[2 * i + 0] = audio;
                         a->out_buff[2 * i + 1] = audio;
 
-                        if ((corr[0] == 0.0) && (corr[1] == 0.0)) corr[0] = 1.0;
-                        det = atan2(corr[1], corr[0]);
-                        del_out = a->fil_out;
-                        a->omega += a->g2 * det;
-                        if (a->omega < a->omega_min) a->omega = a->omega_min;
-                        if (a->omega > a->omega_max) a->omega = a->omega_max;
-                        a->fil_out = a->g1 * det + a->omega;
-                        a->phs += del_out;
-                        while (a->phs >= TWOPI) a->phs -= TWOPI;
-                        while (a->phs < 0.0) a->phs += TWOPI;
+                        det = fast_atan2(corr[1], corr[0]);
+                        del_out = fil_out;
+                        omega += a->g2 * det;
+                        if (omega < a->omega_min) omega = a->omega_min;
+                        if (omega > a->omega_max) omega = a->omega_max;
+                        fil_out = a->g1 * det + omega;
+                        phs += del_out;
+                        while (phs >= TWOPI) phs -= TWOPI;
+                        while (phs < 0.0) phs += TWOPI;
                     }
+                    a->phs = phs;
+                    a->omega = omega;
+                    a->fil_out = fil_out;
+                    a->dc = dc;
+                    a->dc_insert = dc_insert;
+                    memcpy (a->x1, x1, sizeof (x1));
+                    memcpy (a->x2, x2, sizeof (x2));
                     break;
                 }
         }
@@ -32,10 +32,6 @@ warren@wpratt.com
 #define STAGES      7
 #endif
 
-#ifndef OUT_IDX
-#define OUT_IDX     (3 * STAGES)
-#endif
-
 typedef struct _amd
 {
     int run;
@@ -61,12 +57,11 @@ typedef struct _amd
     double onem_mtauR;                  // 1.0 - carrier_removal_multiplier
     double mtauI;                       // carrier insertion multiplier
     double onem_mtauI;                  // 1.0 - carrier_insertion_multiplier
-    double a[3 * STAGES + 3];           // Filter a variables
-    double b[3 * STAGES + 3];           // Filter b variables
-    double c[3 * STAGES + 3];           // Filter c variables
-    double d[3 * STAGES + 3];           // Filter d variables
+    double x1[STAGES + 1][4];           // Filters a, b, c, d - signal at the stage boundaries, 1 sample ago
+    double x2[STAGES + 1][4];           // Filters a, b, c, d - signal at the stage boundaries, 2 samples ago
     double c0[STAGES];                  // Filter coefficients - path 0
     double c1[STAGES];                  // Filter coefficients - path 1
+    double cf[STAGES][4];               // Filter coefficients for a, b, c, d (c0, c1, c0, c1)
     double dsI;                         // delayed sample, I path
     double dsQ;                         // delayed sample, Q path
     double dc_insert;                   // dc component to insert in output
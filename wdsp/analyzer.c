@@ -30,6 +30,21 @@ warren@wpratt.com
 
 DP pdisp[dMAX_DISPLAYS];
 
+// monotonic time in microseconds, for the latency statistics
+static double analyzer_time (void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER count, freq;
+    QueryPerformanceCounter (&count);
+    QueryPerformanceFrequency (&freq);
+    return 1.0e6 * (double)count.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return 1.0e6 * (double)ts.tv_sec + 1.0e-3 * (double)ts.tv_nsec;
+#endif
+}
+
 double bessi0(double x)
 {
     double ax,ans;
@@ -599,6 +614,20 @@ void stitch(int disp)
     }
 }
 
+// called when a pixel frame is complete
+static void update_latency (DP a)
+{
+    double lat = analyzer_time() - a->t_frame;
+    if (a->t_frame <= 0.0)
+        return;
+    EnterCriticalSection(&a->StitchSection);
+    a->lat_sum += lat;
+    a->lat_count++;
+    if (lat > a->lat_max)
+        a->lat_max = lat;
+    LeaveCriticalSection(&a->StitchSection);
+}
+
 DWORD WINAPI spectra (void *pargs)
 {
     int i, j;
@@ -627,7 +656,7 @@ DWORD WINAPI spectra (void *pargs)
             InterlockedDecrement(a->pnum_threads);
             return 0;
         }
-        fftw_execute (a->plan[ss][LO]);
+        xfftplan (a->plan[ss][LO]);
     }
     if (a->stop)
     {
@@ -655,7 +684,9 @@ DWORD WINAPI spectra (void *pargs)
             for (j = 0; j < dMAX_STITCH; j++)
                 for (i = 0; i < dMAX_NUM_FFT; i++)
                     InterlockedBitTestAndReset(&(a->input_busy[j][i]), 0);
+            ReleaseSemaphore(a->hDispatch, 1, 0);
             stitch(disp);
+            update_latency(a);
         }
         else
             LeaveCriticalSection(&a->StitchSection);
@@ -697,7 +728,7 @@ DWORD WINAPI Cspectra (void *pargs)
             InterlockedDecrement(a->pnum_threads);
             return 0;
         }
-        fftw_execute (a->Cplan[ss][LO]);
+        xfftplan (a->Cplan[ss][LO]);
     }
     if (a->stop)
     {
@@ -732,7 +763,9 @@ DWORD WINAPI Cspectra (void *pargs)
             for (j = 0; j < dMAX_STITCH; j++)
                 for (i = 0; i < dMAX_NUM_FFT; i++)
                     InterlockedBitTestAndReset(&(a->input_busy[j][i]), 0);
+            ReleaseSemaphore(a->hDispatch, 1, 0);
             stitch(disp);
+            update_latency(a);
         }
         else
             LeaveCriticalSection(&a->StitchSection);
@@ -881,11 +914,18 @@ int build_interpolants(int disp, int set, int n, int m, double *x, double (*y)[d
     return 0;
 }
 
+//
+// The dispatcher sleeps on hDispatch when there is nothing to do. The semaphore
+// is posted when a buffer becomes ready, when the input buffers are released
+// after a frame is complete, and when the dispatcher is to terminate.
+//
 void __cdecl sendbuf(void *arg)
 {
     DP a = pdisp[(int)(uintptr_t)arg];
+    int dispatched;
     while(!a->end_dispatcher)
     {
+        dispatched = 0;
         for (a->ss = 0; a->ss < a->num_stitch; a->ss++)
             for (a->LO = 0; a->LO < a->num_fft; a->LO++)
             {
@@ -894,6 +934,9 @@ void __cdecl sendbuf(void *arg)
                     InterlockedBitTestAndSet(&(a->input_busy[a->ss][a->LO]), 0);
 
                     a->IQO_idx[a->ss][a->LO] = a->IQout_index[a->ss][a->LO];
+                    if (a->ss == 0 && a->LO == 0)
+                        a->t_frame = a->t_input[0][0];
+                    dispatched = 1;
 
                     InterlockedIncrement(a->pnum_threads);
                     if (a->type == 0)
@@ -910,7 +953,8 @@ void __cdecl sendbuf(void *arg)
                     LeaveCriticalSection(&(a->BufferControlSection[a->ss][a->LO]));
                 }
             }
-        Sleep(1);
+        if (!dispatched)
+            WaitForSingleObject(a->hDispatch, INFINITE);
     }
     InterlockedBitTestAndReset(&a->dispatcher, 0);
     _endthread();
@@ -1022,6 +1066,7 @@ void SetAnalyzer (  int disp,           // display identifier
 
     EnterCriticalSection(&a->SetAnalyzerSection);
     a->end_dispatcher = 1;
+    ReleaseSemaphore(a->hDispatch, 1, 0);
     while (InterlockedAnd(&a->dispatcher, 1))
         Sleep(1);
     a->stop = 1;
@@ -1044,10 +1089,10 @@ void SetAnalyzer (  int disp,           // display identifier
         for (i = 0; i < a->max_stitch; i++)
             for (j = 0; j < a->max_num_fft; j++)
             {
-                if (a->plan[i][j])      fftw_destroy_plan (a->plan[i][j]);
-                if (a->Cplan[i][j])     fftw_destroy_plan (a->Cplan[i][j]);
-                a->plan[i][j] = fftw_plan_dft_r2c_1d(sz, a->fft_in[i][j], a->fft_out[i][j], FFTW_PATIENT);
-                a->Cplan[i][j] = fftw_plan_dft_1d(sz, a->Cfft_in[i][j], a->fft_out[i][j], FFTW_FORWARD, FFTW_PATIENT);
+                if (a->plan[i][j])      destroy_fftplan (a->plan[i][j]);
+                if (a->Cplan[i][j])     destroy_fftplan (a->Cplan[i][j]);
+                a->plan[i][j] = create_fftplan_r2c (sz, a->fft_in[i][j], (double *)a->fft_out[i][j]);
+                a->Cplan[i][j] = create_fftplan_c2c (sz, (double *)a->Cfft_in[i][j], (double *)a->fft_out[i][j], FFTW_FORWARD);
             }
     }
 
@@ -1155,6 +1200,7 @@ void XCreateAnalyzer(   int disp,
     a->max_stitch = m_stitch;
 
     a->pnum_threads = (LONG*) malloc0 (sizeof (LONG));
+    a->hDispatch = CreateSemaphore(0, 0, 1000000, 0);
 
     for (i = 0; i < a->max_stitch; i++)
         for (j = 0; j < a->max_num_fft; j++)
@@ -1242,6 +1288,7 @@ void DestroyAnalyzer(int disp)
     int i, j;
 
     a->end_dispatcher = 1;
+    ReleaseSemaphore(a->hDispatch, 1, 0);
     while (InterlockedAnd(&a->dispatcher, 1))
         Sleep(1);
 
@@ -1279,8 +1326,8 @@ void DestroyAnalyzer(int disp)
     for (i = 0; i < a->max_stitch; i++)
         for (j = 0; j < a->max_num_fft; j++)
         {
-            fftw_destroy_plan (a->plan[i][j]);
-            fftw_destroy_plan (a->Cplan[i][j]);
+            destroy_fftplan (a->plan[i][j]);
+            destroy_fftplan (a->Cplan[i][j]);
             fftw_free (a->Cfft_in[i][j]);
             _aligned_free (a->fft_in[i][j]);
             fftw_free (a->fft_out[i][j]);
@@ -1305,12 +1352,34 @@ void DestroyAnalyzer(int disp)
     for (i = 0; i < a->max_stitch; i++)
         for (j = 0; j < a->max_num_fft; j++)
             CloseHandle(a->hSnapEvent[i][j]);
+    CloseHandle(a->hDispatch);
 
     _aligned_free ((void *) a->pnum_threads);
 
     _aligned_free (a);
 }
 
+//
+// Average and maximum time from the last input sample of a frame to
+// the pixels being available (microseconds). If reset is set, the
+// statistics are cleared after reading them.
+//
+PORT
+void GetDisplayLatency(int disp, double *avg_usec, double *max_usec, int reset)
+{
+    DP a = pdisp[disp];
+    EnterCriticalSection(&a->StitchSection);
+    *avg_usec = a->lat_count > 0 ? a->lat_sum / a->lat_count : 0.0;
+    *max_usec = a->lat_max;
+    if (reset)
+    {
+        a->lat_sum = 0.0;
+        a->lat_max = 0.0;
+        a->lat_count = 0;
+    }
+    LeaveCriticalSection(&a->StitchSection);
+}
+
 PORT
 void GetPixels  (   int disp,
                     int pixout,
@@ -1431,8 +1500,10 @@ void CloseBuffer(int disp, int ss, int LO)
                         a->IQout_index[ss][LO] -= a->bsize;
                 a->have_samples[ss][LO] = a->max_writeahead;
             }
+        a->t_input[ss][LO] = analyzer_time();
         if ((a->have_samples[ss][LO] += a->buff_size) >= a->size)
-            InterlockedBitTestAndSet(&(a->buff_ready[ss][LO]), 0);
+            if (!InterlockedBitTestAndSet(&(a->buff_ready[ss][LO]), 0))
+                ReleaseSemaphore(a->hDispatch, 1, 0);
     LeaveCriticalSection(&(a->BufferControlSection[ss][LO]));
     if((a->IQin_index[ss][LO] += a->buff_size) >= a->bsize) //REQUIRES buff_size IS A SUB-MULTIPLE OF SIZE OF INPUT SAMPLE BUFFS!
         a->IQin_index[ss][LO] = 0;
@@ -1470,8 +1541,10 @@ void Spectrum(int disp, int ss, int LO, dINREAL* pI, dINREAL* pQ)
                         a->IQout_index[ss][LO] -= a->bsize;
                 a->have_samples[ss][LO] = a->max_writeahead;
             }
+        a->t_input[ss][LO] = analyzer_time();
         if ((a->have_samples[ss][LO] += a->buff_size) >= a->size)
-            InterlockedBitTestAndSet(&(a->buff_ready[ss][LO]), 0);
+            if (!InterlockedBitTestAndSet(&(a->buff_ready[ss][LO]), 0))
+                ReleaseSemaphore(a->hDispatch, 1, 0);
     LeaveCriticalSection(&(a->BufferControlSection[ss][LO]));
     if((a->IQin_index[ss][LO] += a->buff_size) >= a->bsize) //REQUIRES buff_size IS A SUB-MULTIPLE OF SIZE OF INPUT SAMPLE BUFFS!
         a->IQin_index[ss][LO] = 0;
@@ -1515,8 +1588,10 @@ void Spectrum2(int run, int disp, int ss, int LO, dINREAL* pbuff)
                             a->IQout_index[ss][LO] -= a->bsize;
                     a->have_samples[ss][LO] = a->max_writeahead;
                 }
+            a->t_input[ss][LO] = analyzer_time();
             if ((a->have_samples[ss][LO] += a->buff_size) >= a->size)
-                InterlockedBitTestAndSet(&(a->buff_ready[ss][LO]), 0);
+                if (!InterlockedBitTestAndSet(&(a->buff_ready[ss][LO]), 0))
+                    ReleaseSemaphore(a->hDispatch, 1, 0);
         LeaveCriticalSection(&(a->BufferControlSection[ss][LO]));
         if((a->IQin_index[ss][LO] += a->buff_size) >= a->bsize) //REQUIRES buff_size IS A SUB-MULTIPLE OF SIZE OF INPUT SAMPLE BUFFS!
             a->IQin_index[ss][LO] = 0;
@@ -1561,8 +1636,10 @@ void Spectrum0(int run, int disp, int ss, int LO, double* pbuff)
                         a->IQout_index[ss][LO] -= a->bsize;
                     a->have_samples[ss][LO] = a->max_writeahead;
                 }
+            a->t_input[ss][LO] = analyzer_time();
             if ((a->have_samples[ss][LO] += a->buff_size) >= a->size)
-                InterlockedBitTestAndSet(&(a->buff_ready[ss][LO]), 0);
+                if (!InterlockedBitTestAndSet(&(a->buff_ready[ss][LO]), 0))
+                    ReleaseSemaphore(a->hDispatch, 1, 0);
         LeaveCriticalSection(&(a->BufferControlSection[ss][LO]));
         if((a->IQin_index[ss][LO] += a->buff_size) >= a->bsize) //REQUIRES buff_size IS A SUB-MULTIPLE OF SIZE OF INPUT SAMPLE BUFFS!
             a->IQin_index[ss][LO] = 0;
@@ -92,8 +92,8 @@ typedef struct _dp
     double (*ac1[dMAX_CAL_SETS][dMAX_M]);
     double (*ac0[dMAX_CAL_SETS][dMAX_M]);
 
-    fftw_plan plan[dMAX_STITCH][dMAX_NUM_FFT];              // fftw plans
-    fftw_plan Cplan[dMAX_STITCH][dMAX_NUM_FFT];
+    FFTPLAN plan[dMAX_STITCH][dMAX_NUM_FFT];              // fftw plans
+    FFTPLAN Cplan[dMAX_STITCH][dMAX_NUM_FFT];
     double *fft_in[dMAX_STITCH][dMAX_NUM_FFT];              // pointers to fftw real input vectors
     fftw_complex *Cfft_in[dMAX_STITCH][dMAX_NUM_FFT];       // pointers to fftw complex input vectors
     fftw_complex *fft_out[dMAX_STITCH][dMAX_NUM_FFT];       // pointers to fftw complex output vectors
@@ -128,6 +128,12 @@ typedef struct _dp
     volatile LONG snap[dMAX_STITCH][dMAX_NUM_FFT];          // set to 1 to allow a snap of raw spectrum data
     HANDLE hSnapEvent[dMAX_STITCH][dMAX_NUM_FFT];           // mutex handles; mutexes will be used to signal a snap is complete
     double *snap_buff[dMAX_STITCH][dMAX_NUM_FFT];           // pointers to buffers for the snap
+    HANDLE hDispatch;                                       // semaphore posted when the dispatcher may have work
+    double t_input[dMAX_STITCH][dMAX_NUM_FFT];              // time (usec) of the last input to a buffer
+    double t_frame;                                         // t_input of the buffer starting the frame in progress
+    double lat_sum;                                         // sum of input-to-pixel latencies (usec)
+    double lat_max;                                         // maximum input-to-pixel latency (usec)
+    int lat_count;                                          // number of frames in lat_sum
 
     CRITICAL_SECTION PB_ControlsSection[dMAX_PIXOUTS];
     CRITICAL_SECTION SetAnalyzerSection;
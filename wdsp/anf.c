@@ -67,9 +67,10 @@ ANF create_anf  (
     a->den_mult = den_mult;
     a->lincr = lincr;
     a->ldecr = ldecr;
+    init_dotprod();
 
-    memset (a->d, 0, sizeof(double) * ANF_DLINE_SIZE);
-    memset (a->w, 0, sizeof(double) * ANF_DLINE_SIZE);
+    memset (a->d, 0, sizeof(real) * 2 * ANF_DLINE_SIZE);
+    memset (a->w, 0, sizeof(real) * ANF_DLINE_SIZE);
 
     return a;
 }
@@ -81,25 +82,20 @@ void destroy_anf (ANF a)
 
 void xanf(ANF a, int position)
 {
-    int i, j, idx;
+    int i;
     double c0, c1;
+    real* x;
     double y, error, sigma, inv_sigp;
     double nel, nev;
     if (a->run && (a->position == position))
     {
         for (i = 0; i < a->buff_size; i++)
         {
-            a->d[a->in_idx] = a->in_buff[2 * i + 0];
+            // the delay line is stored twice, the taps are contiguous at d + ((in_idx + delay) & mask)
+            a->d[a->in_idx] = a->d[a->in_idx + a->dline_size] = (real)a->in_buff[2 * i + 0];
+            x = a->d + ((a->in_idx + a->delay) & a->mask);
 
-            y = 0;
-            sigma = 0;
-
-            for (j = 0; j < a->n_taps; j++)
-            {
-                idx = (a->in_idx + j + a->delay) & a->mask;
-                y += a->w[j] * a->d[idx];
-                sigma += a->d[idx] * a->d[idx];
-            }
+            y = dotprod_rre_real (a->w, x, a->n_taps, &sigma);
             inv_sigp = 1.0 / (sigma + 1e-10);
             error = a->d[a->in_idx] - y;
 
@@ -121,11 +117,7 @@ void xanf(ANF a, int position)
             c0 = 1.0 - a->two_mu * a->ngamma;
             c1 = a->two_mu * error * inv_sigp;
 
-            for (j = 0; j < a->n_taps; j++)
-            {
-                idx = (a->in_idx + j + a->delay) & a->mask;
-                a->w[j] = c0 * a->w[j] + c1 * a->d[idx];
-            }
+            scale_add_rr_real (a->w, x, a->n_taps, c0, c1);
             a->in_idx = (a->in_idx + a->mask) & a->mask;
         }
     }
@@ -135,8 +127,8 @@ void xanf(ANF a, int position)
 
 void flush_anf (ANF a)
 {
-    memset (a->d, 0, sizeof(double) * ANF_DLINE_SIZE);
-    memset (a->w, 0, sizeof(double) * ANF_DLINE_SIZE);
+    memset (a->d, 0, sizeof(real) * 2 * ANF_DLINE_SIZE);
+    memset (a->w, 0, sizeof(real) * ANF_DLINE_SIZE);
     a->in_idx = 0;
 }
 
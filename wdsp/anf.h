@@ -42,8 +42,8 @@ typedef struct _anf
     int delay;
     double two_mu;
     double gamma;
-    double d [ANF_DLINE_SIZE];
-    double w [ANF_DLINE_SIZE];
+    real d [2 * ANF_DLINE_SIZE];       // delay line, stored twice
+    real w [ANF_DLINE_SIZE];
     int in_idx;
 
     double lidx;
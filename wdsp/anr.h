@@ -42,8 +42,8 @@ typedef struct _anr
     int delay;
     double two_mu;
     double gamma;
-    double d [ANR_DLINE_SIZE];
-    double w [ANR_DLINE_SIZE];
+    real d [2 * ANR_DLINE_SIZE];       // delay line, stored twice
+    real w [ANR_DLINE_SIZE];
     int in_idx;
 
     double lidx;
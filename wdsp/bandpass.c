@@ -39,15 +39,15 @@ void calc_bps (BPS a)
     a->product = (double *)malloc0(2 * a->size * sizeof(complex));
     impulse = fir_bandpass(a->size + 1, a->f_low, a->f_high, a->samplerate, a->wintype, 1, 1.0 / (double)(2 * a->size));
     a->mults = fftcv_mults(2 * a->size, impulse);
-    a->CFor = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->infilt, (fftw_complex *)a->product, FFTW_FORWARD, FFTW_PATIENT);
-    a->CRev = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->product, (fftw_complex *)a->out, FFTW_BACKWARD, FFTW_PATIENT);
+    a->CFor = create_fftplan_c2c (2 * a->size, a->infilt, a->product, FFTW_FORWARD);
+    a->CRev = create_fftplan_c2c (2 * a->size, a->product, a->out, FFTW_BACKWARD);
     _aligned_free(impulse);
 }
 
 void decalc_bps (BPS a)
 {
-    fftw_destroy_plan(a->CRev);
-    fftw_destroy_plan(a->CFor);
+    destroy_fftplan (a->CRev);
+    destroy_fftplan (a->CFor);
     _aligned_free(a->mults);
     _aligned_free(a->product);
     _aligned_free(a->infilt);
@@ -89,7 +89,7 @@ void xbps (BPS a, int pos)
     if (a->run && pos == a->position)
     {
         memcpy (&(a->infilt[2 * a->size]), a->in, a->size * sizeof (complex));
-        fftw_execute (a->CFor);
+        xfftplan (a->CFor);
         for (i = 0; i < 2 * a->size; i++)
         {
             I = a->gain * a->product[2 * i + 0];
@@ -97,7 +97,7 @@ void xbps (BPS a, int pos)
             a->product[2 * i + 0] = I * a->mults[2 * i + 0] - Q * a->mults[2 * i + 1];
             a->product[2 * i + 1] = I * a->mults[2 * i + 1] + Q * a->mults[2 * i + 0];
         }
-        fftw_execute (a->CRev);
+        xfftplan (a->CRev);
         memcpy (a->infilt, &(a->infilt[2 * a->size]), a->size * sizeof(complex));
     }
     else if (a->in != a->out)
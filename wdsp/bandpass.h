@@ -48,8 +48,8 @@ typedef struct _bps
     double samplerate;
     int wintype;
     double gain;
-    fftw_plan CFor;
-    fftw_plan CRev;
+    FFTPLAN CFor;
+    FFTPLAN CRev;
 }bps, *BPS;
 
 extern BPS create_bps (int run, int position, int size, double* in, double* out,
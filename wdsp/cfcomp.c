@@ -178,8 +178,8 @@ void calc_cfcomp(CFCOMP a)
     a->outaccum = (double *)malloc0(a->oasize * sizeof(double));
     a->nsamps = 0;
     a->saveidx = 0;
-    a->Rfor = fftw_plan_dft_r2c_1d(a->fsize, a->forfftin, (fftw_complex *)a->forfftout, FFTW_ESTIMATE);
-    a->Rrev = fftw_plan_dft_c2r_1d(a->fsize, (fftw_complex *)a->revfftin, a->revfftout, FFTW_ESTIMATE);
+    a->Rfor = create_fftplan_r2c (a->fsize, a->forfftin, a->forfftout);
+    a->Rrev = create_fftplan_c2r (a->fsize, a->revfftin, a->revfftout);
     calc_cfcwindow(a);
 
     a->pregain  = (2.0 * a->winfudge) / (double)a->fsize;
@@ -213,8 +213,8 @@ void decalc_cfcomp(CFCOMP a)
     _aligned_free (a->gp);
     _aligned_free (a->fp);
 
-    fftw_destroy_plan(a->Rrev);
-    fftw_destroy_plan(a->Rfor);
+    destroy_fftplan (a->Rrev);
+    destroy_fftplan (a->Rfor);
     _aligned_free(a->outaccum);
     for (i = 0; i < a->ovrlp; i++)
         _aligned_free(a->save[i]);
@@ -348,14 +348,14 @@ void xcfcomp (CFCOMP a, int pos)
                 a->forfftin[i] = a->pregain * a->window[i] * a->inaccum[j];
             a->iaoutidx = (a->iaoutidx + a->incr) % a->iasize;
             a->nsamps -= a->incr;
-            fftw_execute (a->Rfor);
+            xfftplan (a->Rfor);
             calc_mask(a);
             for (i = 0; i < a->msize; i++)
             {
                 a->revfftin[2 * i + 0] = a->mask[i] * a->forfftout[2 * i + 0];
                 a->revfftin[2 * i + 1] = a->mask[i] * a->forfftout[2 * i + 1];
             }
-            fftw_execute (a->Rrev);
+            xfftplan (a->Rrev);
             for (i = 0; i < a->fsize; i++)
                 a->save[a->saveidx][i] = a->postgain * a->window[i] * a->revfftout[i];
             for (i = a->ovrlp; i > 0; i--)
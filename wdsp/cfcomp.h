@@ -63,8 +63,8 @@ typedef struct _cfcomp
     int oainidx;
     int oaoutidx;
     int saveidx;
-    fftw_plan Rfor;
-    fftw_plan Rrev;
+    FFTPLAN Rfor;
+    FFTPLAN Rrev;
 
     int comp_method;
     int nfreqs;
@@ -124,6 +124,7 @@ void CloseChannel (int channel)
 {
     pre_main_destroy (channel);
     destroy_main (channel);
+    ch[channel].iob.span = NULL;                            // retired r1 is freed, too
     post_main_destroy (channel);
 }
 
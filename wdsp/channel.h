@@ -54,6 +54,8 @@ struct _ch
     {
         IOB pc, pd, pe, pf;     // copies for console calls, dsp, exchange, and flush thread
         volatile long ch_upslew;
+        double* volatile span;  // last span handed out by fexchange_acquire()
+        void* volatile retired; // r1 of destroyed buffers, still holding span
     } iob;
 };
 
@@ -53,6 +53,15 @@ warren@wpratt.com
 #include <avrt.h>
 #endif
 #include "fftw3.h"
+#include "fftplan.h"
+
+// sample type of the time-domain filter state (delay lines, rings, taps), see WDSP_REAL in the Makefile;
+// buffers between the stages, FFT data, filter design, and the AGC stay in double
+#ifdef WDSP_REAL_FLOAT
+typedef float real;
+#else
+typedef double real;
+#endif
 
 #include "amd.h"
 #include "ammod.h"
@@ -70,10 +79,12 @@ warren@wpratt.com
 #include "delay.h"
 #include "dexp.h"
 #include "div.h"
+#include "dotprod.h"
 #include "eer.h"
 #include "emnr.h"
 #include "emph.h"
 #include "eq.h"
+#include "fastmath.h"
 #include "fcurve.h"
 #include "fir.h"
 #include "firmin.h"
@@ -0,0 +1,593 @@
+/*  dotprod.c
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 the piHPSDR authors
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#include "comm.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DOTPROD_AVX2
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define DOTPROD_NEON
+#include <arm_neon.h>
+#endif
+
+/********************************************************************************************************
+*                                                                                                       *
+*                                           Dot Products                                                *
+*                                                                                                       *
+*   Inner loops of the FIR filters in time domain (resamplers, LMS).  The AVX2/FMA versions are        *
+*   selected at runtime by init_dotprod(), NEON is always there on 64-bit ARM.  The vector versions    *
+*   sum in a different order than the scalar ones, so results differ in the last bits.                  *
+*                                                                                                       *
+********************************************************************************************************/
+
+static void dotprod_cr_scalar (double* h, double* x, int n, double* I, double* Q)
+{
+    int j;
+    double sI = 0.0, sQ = 0.0;
+    for (j = 0; j < n; j++)
+    {
+        sI += h[j] * x[2 * j + 0];
+        sQ += h[j] * x[2 * j + 1];
+    }
+    *I = sI;
+    *Q = sQ;
+}
+
+static double dotprod_rr_scalar (double* h, double* x, int n)
+{
+    int j;
+    double s = 0.0;
+    for (j = 0; j < n; j++)
+        s += h[j] * x[j];
+    return s;
+}
+
+static float dotprod_rrf_scalar (float* h, float* x, int n)
+{
+    int j;
+    float s = 0.0f;
+    for (j = 0; j < n; j++)
+        s += h[j] * x[j];
+    return s;
+}
+
+static double dotprod_rre_scalar (double* h, double* x, int n, double* e)
+{
+    int j;
+    double s = 0.0, se = 0.0;
+    for (j = 0; j < n; j++)
+    {
+        s  += h[j] * x[j];
+        se += x[j] * x[j];
+    }
+    *e = se;
+    return s;
+}
+
+static void scale_add_rr_scalar (double* w, double* x, int n, double c0, double c1)
+{
+    int j;
+    for (j = 0; j < n; j++)
+        w[j] = c0 * w[j] + c1 * x[j];
+}
+
+static void dotprod_crf_scalar (float* h, float* x, int n, double* I, double* Q)
+{
+    int j;
+    float sI = 0.0f, sQ = 0.0f;
+    for (j = 0; j < n; j++)
+    {
+        sI += h[j] * x[2 * j + 0];
+        sQ += h[j] * x[2 * j + 1];
+    }
+    *I = sI;
+    *Q = sQ;
+}
+
+static double dotprod_rref_scalar (float* h, float* x, int n, double* e)
+{
+    int j;
+    float s = 0.0f, se = 0.0f;
+    for (j = 0; j < n; j++)
+    {
+        s  += h[j] * x[j];
+        se += x[j] * x[j];
+    }
+    *e = se;
+    return s;
+}
+
+static void scale_add_rrf_scalar (float* w, float* x, int n, double c0, double c1)
+{
+    int j;
+    float fc0 = (float)c0, fc1 = (float)c1;
+    for (j = 0; j < n; j++)
+        w[j] = fc0 * w[j] + fc1 * x[j];
+}
+
+#if defined(DOTPROD_AVX2)
+__attribute__((target("avx2,fma")))
+static void dotprod_cr_avx2 (double* h, double* x, int n, double* I, double* Q)
+{
+    int j;
+    double t[4];
+    __m256d hv;
+    __m256d acc0 = _mm256_setzero_pd ();
+    __m256d acc1 = _mm256_setzero_pd ();
+    for (j = 0; j + 4 <= n; j += 4)
+    {
+        hv = _mm256_loadu_pd (h + j);
+        acc0 = _mm256_fmadd_pd (_mm256_permute4x64_pd (hv, 0x50), _mm256_loadu_pd (x + 2 * j + 0), acc0);  // h0 h0 h1 h1
+        acc1 = _mm256_fmadd_pd (_mm256_permute4x64_pd (hv, 0xFA), _mm256_loadu_pd (x + 2 * j + 4), acc1);  // h2 h2 h3 h3
+    }
+    _mm256_storeu_pd (t, _mm256_add_pd (acc0, acc1));
+    dotprod_cr_scalar (h + j, x + 2 * j, n - j, I, Q);
+    *I += t[0] + t[2];
+    *Q += t[1] + t[3];
+}
+
+__attribute__((target("avx2,fma")))
+static double dotprod_rr_avx2 (double* h, double* x, int n)
+{
+    int j;
+    double t[4];
+    __m256d acc0 = _mm256_setzero_pd ();
+    __m256d acc1 = _mm256_setzero_pd ();
+    for (j = 0; j + 8 <= n; j += 8)
+    {
+        acc0 = _mm256_fmadd_pd (_mm256_loadu_pd (h + j + 0), _mm256_loadu_pd (x + j + 0), acc0);
+        acc1 = _mm256_fmadd_pd (_mm256_loadu_pd (h + j + 4), _mm256_loadu_pd (x + j + 4), acc1);
+    }
+    _mm256_storeu_pd (t, _mm256_add_pd (acc0, acc1));
+    return (t[0] + t[1]) + (t[2] + t[3]) + dotprod_rr_scalar (h + j, x + j, n - j);
+}
+
+__attribute__((target("avx2,fma")))
+static float dotprod_rrf_avx2 (float* h, float* x, int n)
+{
+    int j;
+    float t[8];
+    __m256 acc0 = _mm256_setzero_ps ();
+    __m256 acc1 = _mm256_setzero_ps ();
+    for (j = 0; j + 16 <= n; j += 16)
+    {
+        acc0 = _mm256_fmadd_ps (_mm256_loadu_ps (h + j + 0), _mm256_loadu_ps (x + j + 0), acc0);
+        acc1 = _mm256_fmadd_ps (_mm256_loadu_ps (h + j + 8), _mm256_loadu_ps (x + j + 8), acc1);
+    }
+    _mm256_storeu_ps (t, _mm256_add_ps (acc0, acc1));
+    return ((t[0] + t[1]) + (t[2] + t[3])) + ((t[4] + t[5]) + (t[6] + t[7])) + dotprod_rrf_scalar (h + j, x + j, n - j);
+}
+
+__attribute__((target("avx2,fma")))
+static double dotprod_rre_avx2 (double* h, double* x, int n, double* e)
+{
+    int j;
+    double t[4], te[4], s;
+    __m256d x0, x1;
+    __m256d acc0 = _mm256_setzero_pd ();
+    __m256d acc1 = _mm256_setzero_pd ();
+    __m256d ene0 = _mm256_setzero_pd ();
+    __m256d ene1 = _mm256_setzero_pd ();
+    for (j = 0; j + 8 <= n; j += 8)
+    {
+        x0 = _mm256_loadu_pd (x + j + 0);
+        x1 = _mm256_loadu_pd (x + j + 4);
+        acc0 = _mm256_fmadd_pd (_mm256_loadu_pd (h + j + 0), x0, acc0);
+        acc1 = _mm256_fmadd_pd (_mm256_loadu_pd (h + j + 4), x1, acc1);
+        ene0 = _mm256_fmadd_pd (x0, x0, ene0);
+        ene1 = _mm256_fmadd_pd (x1, x1, ene1);
+    }
+    _mm256_storeu_pd (t, _mm256_add_pd (acc0, acc1));
+    _mm256_storeu_pd (te, _mm256_add_pd (ene0, ene1));
+    s = dotprod_rre_scalar (h + j, x + j, n - j, e);
+    *e += (te[0] + te[1]) + (te[2] + te[3]);
+    return (t[0] + t[1]) + (t[2] + t[3]) + s;
+}
+
+__attribute__((target("avx2,fma")))
+static void scale_add_rr_avx2 (double* w, double* x, int n, double c0, double c1)
+{
+    int j;
+    __m256d c0v = _mm256_set1_pd (c0);
+    __m256d c1v = _mm256_set1_pd (c1);
+    for (j = 0; j + 4 <= n; j += 4)
+        _mm256_storeu_pd (w + j, _mm256_fmadd_pd (c0v, _mm256_loadu_pd (w + j), _mm256_mul_pd (c1v, _mm256_loadu_pd (x + j))));
+    scale_add_rr_scalar (w + j, x + j, n - j, c0, c1);
+}
+
+__attribute__((target("avx2,fma")))
+static void dotprod_crf_avx2 (float* h, float* x, int n, double* I, double* Q)
+{
+    int j;
+    float t[8];
+    __m256 hv;
+    __m256 acc0 = _mm256_setzero_ps ();
+    __m256 acc1 = _mm256_setzero_ps ();
+    const __m256i lo = _mm256_setr_epi32 (0, 0, 1, 1, 2, 2, 3, 3);
+    const __m256i hi = _mm256_setr_epi32 (4, 4, 5, 5, 6, 6, 7, 7);
+    for (j = 0; j + 8 <= n; j += 8)
+    {
+        hv = _mm256_loadu_ps (h + j);
+        acc0 = _mm256_fmadd_ps (_mm256_permutevar8x32_ps (hv, lo), _mm256_loadu_ps (x + 2 * j + 0), acc0);
+        acc1 = _mm256_fmadd_ps (_mm256_permutevar8x32_ps (hv, hi), _mm256_loadu_ps (x + 2 * j + 8), acc1);
+    }
+    _mm256_storeu_ps (t, _mm256_add_ps (acc0, acc1));
+    dotprod_crf_scalar (h + j, x + 2 * j, n - j, I, Q);
+    *I += (double)(((t[0] + t[2]) + (t[4] + t[6])));
+    *Q += (double)(((t[1] + t[3]) + (t[5] + t[7])));
+}
+
+__attribute__((target("avx2,fma")))
+static double dotprod_rref_avx2 (float* h, float* x, int n, double* e)
+{
+    int j;
+    float t[8], te[8];
+    double s;
+    __m256 x0, x1;
+    __m256 acc0 = _mm256_setzero_ps ();
+    __m256 acc1 = _mm256_setzero_ps ();
+    __m256 ene0 = _mm256_setzero_ps ();
+    __m256 ene1 = _mm256_setzero_ps ();
+    for (j = 0; j + 16 <= n; j += 16)
+    {
+        x0 = _mm256_loadu_ps (x + j + 0);
+        x1 = _mm256_loadu_ps (x + j + 8);
+        acc0 = _mm256_fmadd_ps (_mm256_loadu_ps (h + j + 0), x0, acc0);
+        acc1 = _mm256_fmadd_ps (_mm256_loadu_ps (h + j + 8), x1, acc1);
+        ene0 = _mm256_fmadd_ps (x0, x0, ene0);
+        ene1 = _mm256_fmadd_ps (x1, x1, ene1);
+    }
+    _mm256_storeu_ps (t, _mm256_add_ps (acc0, acc1));
+    _mm256_storeu_ps (te, _mm256_add_ps (ene0, ene1));
+    s = dotprod_rref_scalar (h + j, x + j, n - j, e);
+    *e += ((te[0] + te[1]) + (te[2] + te[3])) + ((te[4] + te[5]) + (te[6] + te[7]));
+    return ((t[0] + t[1]) + (t[2] + t[3])) + ((t[4] + t[5]) + (t[6] + t[7])) + s;
+}
+
+__attribute__((target("avx2,fma")))
+static void scale_add_rrf_avx2 (float* w, float* x, int n, double c0, double c1)
+{
+    int j;
+    __m256 c0v = _mm256_set1_ps ((float)c0);
+    __m256 c1v = _mm256_set1_ps ((float)c1);
+    for (j = 0; j + 8 <= n; j += 8)
+        _mm256_storeu_ps (w + j, _mm256_fmadd_ps (c0v, _mm256_loadu_ps (w + j), _mm256_mul_ps (c1v, _mm256_loadu_ps (x + j))));
+    scale_add_rrf_scalar (w + j, x + j, n - j, c0, c1);
+}
+#endif
+
+#if defined(DOTPROD_NEON)
+static void dotprod_cr_neon (double* h, double* x, int n, double* I, double* Q)
+{
+    int j;
+    float64x2_t acc0 = vdupq_n_f64 (0.0);
+    float64x2_t acc1 = vdupq_n_f64 (0.0);
+    for (j = 0; j + 2 <= n; j += 2)
+    {
+        acc0 = vfmaq_n_f64 (acc0, vld1q_f64 (x + 2 * j + 0), h[j + 0]);
+        acc1 = vfmaq_n_f64 (acc1, vld1q_f64 (x + 2 * j + 2), h[j + 1]);
+    }
+    acc0 = vaddq_f64 (acc0, acc1);
+    dotprod_cr_scalar (h + j, x + 2 * j, n - j, I, Q);
+    *I += vgetq_lane_f64 (acc0, 0);
+    *Q += vgetq_lane_f64 (acc0, 1);
+}
+
+static double dotprod_rr_neon (double* h, double* x, int n)
+{
+    int j;
+    float64x2_t acc0 = vdupq_n_f64 (0.0);
+    float64x2_t acc1 = vdupq_n_f64 (0.0);
+    for (j = 0; j + 4 <= n; j += 4)
+    {
+        acc0 = vfmaq_f64 (acc0, vld1q_f64 (h + j + 0), vld1q_f64 (x + j + 0));
+        acc1 = vfmaq_f64 (acc1, vld1q_f64 (h + j + 2), vld1q_f64 (x + j + 2));
+    }
+    return vaddvq_f64 (vaddq_f64 (acc0, acc1)) + dotprod_rr_scalar (h + j, x + j, n - j);
+}
+
+static float dotprod_rrf_neon (float* h, float* x, int n)
+{
+    int j;
+    float32x4_t acc0 = vdupq_n_f32 (0.0f);
+    float32x4_t acc1 = vdupq_n_f32 (0.0f);
+    for (j = 0; j + 8 <= n; j += 8)
+    {
+        acc0 = vfmaq_f32 (acc0, vld1q_f32 (h + j + 0), vld1q_f32 (x + j + 0));
+        acc1 = vfmaq_f32 (acc1, vld1q_f32 (h + j + 4), vld1q_f32 (x + j + 4));
+    }
+    return vaddvq_f32 (vaddq_f32 (acc0, acc1)) + dotprod_rrf_scalar (h + j, x + j, n - j);
+}
+
+static double dotprod_rre_neon (double* h, double* x, int n, double* e)
+{
+    int j;
+    double s;
+    float64x2_t x0, x1;
+    float64x2_t acc0 = vdupq_n_f64 (0.0);
+    float64x2_t acc1 = vdupq_n_f64 (0.0);
+    float64x2_t ene0 = vdupq_n_f64 (0.0);
+    float64x2_t ene1 = vdupq_n_f64 (0.0);
+    for (j = 0; j + 4 <= n; j += 4)
+    {
+        x0 = vld1q_f64 (x + j + 0);
+        x1 = vld1q_f64 (x + j + 2);
+        acc0 = vfmaq_f64 (acc0, vld1q_f64 (h + j + 0), x0);
+        acc1 = vfmaq_f64 (acc1, vld1q_f64 (h + j + 2), x1);
+        ene0 = vfmaq_f64 (ene0, x0, x0);
+        ene1 = vfmaq_f64 (ene1, x1, x1);
+    }
+    s = dotprod_rre_scalar (h + j, x + j, n - j, e);
+    *e += vaddvq_f64 (vaddq_f64 (ene0, ene1));
+    return vaddvq_f64 (vaddq_f64 (acc0, acc1)) + s;
+}
+
+static void scale_add_rr_neon (double* w, double* x, int n, double c0, double c1)
+{
+    int j;
+    for (j = 0; j + 2 <= n; j += 2)
+        vst1q_f64 (w + j, vfmaq_n_f64 (vmulq_n_f64 (vld1q_f64 (x + j), c1), vld1q_f64 (w + j), c0));
+    scale_add_rr_scalar (w + j, x + j, n - j, c0, c1);
+}
+
+static void dotprod_crf_neon (float* h, float* x, int n, double* I, double* Q)
+{
+    int j;
+    float32x4x2_t xv;
+    float32x4_t hv;
+    float32x4_t accI = vdupq_n_f32 (0.0f);
+    float32x4_t accQ = vdupq_n_f32 (0.0f);
+    for (j = 0; j + 4 <= n; j += 4)
+    {
+        xv = vld2q_f32 (x + 2 * j);     // de-interleaves I and Q
+        hv = vld1q_f32 (h + j);
+        accI = vfmaq_f32 (accI, hv, xv.val[0]);
+        accQ = vfmaq_f32 (accQ, hv, xv.val[1]);
+    }
+    dotprod_crf_scalar (h + j, x + 2 * j, n - j, I, Q);
+    *I += vaddvq_f32 (accI);
+    *Q += vaddvq_f32 (accQ);
+}
+
+static double dotprod_rref_neon (float* h, float* x, int n, double* e)
+{
+    int j;
+    double s;
+    float32x4_t x0, x1;
+    float32x4_t acc0 = vdupq_n_f32 (0.0f);
+    float32x4_t acc1 = vdupq_n_f32 (0.0f);
+    float32x4_t ene0 = vdupq_n_f32 (0.0f);
+    float32x4_t ene1 = vdupq_n_f32 (0.0f);
+    for (j = 0; j + 8 <= n; j += 8)
+    {
+        x0 = vld1q_f32 (x + j + 0);
+        x1 = vld1q_f32 (x + j + 4);
+        acc0 = vfmaq_f32 (acc0, vld1q_f32 (h + j + 0), x0);
+        acc1 = vfmaq_f32 (acc1, vld1q_f32 (h + j + 4), x1);
+        ene0 = vfmaq_f32 (ene0, x0, x0);
+        ene1 = vfmaq_f32 (ene1, x1, x1);
+    }
+    s = dotprod_rref_scalar (h + j, x + j, n - j, e);
+    *e += vaddvq_f32 (vaddq_f32 (ene0, ene1));
+    return vaddvq_f32 (vaddq_f32 (acc0, acc1)) + s;
+}
+
+static void scale_add_rrf_neon (float* w, float* x, int n, double c0, double c1)
+{
+    int j;
+    for (j = 0; j + 4 <= n; j += 4)
+        vst1q_f32 (w + j, vfmaq_n_f32 (vmulq_n_f32 (vld1q_f32 (x + j), (float)c1), vld1q_f32 (w + j), (float)c0));
+    scale_add_rrf_scalar (w + j, x + j, n - j, c0, c1);
+}
+#endif
+
+/********************************************************************************************************
+*                                                                                                       *
+*                               Complex Multiply-Accumulate, acc[i] += x[i] * m[i]                      *
+*                                                                                                       *
+*   Used for the frequency-domain convolution of the partitioned filters (firmin.c).  Interleaved       *
+*   complex, n is the number of complex values.  Selected by init_dotprod() like the dot products.      *
+*   Keeping the masks split into real and imaginary arrays was tried and did not pay.                   *
+*                                                                                                       *
+********************************************************************************************************/
+
+static void cmac_scalar (double* acc, double* x, double* m, int n)
+{
+    int i;
+    for (i = 0; i < n; i++)
+    {
+        acc[2 * i + 0] += x[2 * i + 0] * m[2 * i + 0] - x[2 * i + 1] * m[2 * i + 1];
+        acc[2 * i + 1] += x[2 * i + 0] * m[2 * i + 1] + x[2 * i + 1] * m[2 * i + 0];
+    }
+}
+
+#if defined(DOTPROD_AVX2)
+__attribute__((target("avx2,fma")))
+static void cmac_avx2 (double* acc, double* x, double* m, int n)
+{
+    int i;
+    __m256d x0, x1, m0, m1, a0, a1;
+    for (i = 0; i + 4 <= n; i += 4)
+    {
+        x0 = _mm256_loadu_pd (x + 2 * i);
+        x1 = _mm256_loadu_pd (x + 2 * i + 4);
+        m0 = _mm256_loadu_pd (m + 2 * i);
+        m1 = _mm256_loadu_pd (m + 2 * i + 4);
+        a0 = _mm256_loadu_pd (acc + 2 * i);
+        a1 = _mm256_loadu_pd (acc + 2 * i + 4);
+        // (xr * mr - xi * mi, xi * mr + xr * mi)
+        a0 = _mm256_add_pd (a0, _mm256_fmaddsub_pd (x0, _mm256_movedup_pd (m0),
+            _mm256_mul_pd (_mm256_permute_pd (x0, 0x5), _mm256_permute_pd (m0, 0xF))));
+        a1 = _mm256_add_pd (a1, _mm256_fmaddsub_pd (x1, _mm256_movedup_pd (m1),
+            _mm256_mul_pd (_mm256_permute_pd (x1, 0x5), _mm256_permute_pd (m1, 0xF))));
+        _mm256_storeu_pd (acc + 2 * i, a0);
+        _mm256_storeu_pd (acc + 2 * i + 4, a1);
+    }
+    cmac_scalar (acc + 2 * i, x + 2 * i, m + 2 * i, n - i);
+}
+#endif
+
+#if defined(DOTPROD_NEON)
+static void cmac_neon (double* acc, double* x, double* m, int n)
+{
+    int i;
+    const float64x2_t sign = {-1.0, 1.0};
+    float64x2_t xv, mv, av;
+    for (i = 0; i < n; i++)
+    {
+        xv = vld1q_f64 (x + 2 * i);
+        mv = vld1q_f64 (m + 2 * i);
+        av = vld1q_f64 (acc + 2 * i);
+        av = vfmaq_laneq_f64 (av, xv, mv, 0);                                                   // (xr * mr, xi * mr)
+        av = vfmaq_f64 (av, vextq_f64 (xv, xv, 1), vmulq_f64 (vdupq_laneq_f64 (mv, 1), sign));  // (-xi * mi, xr * mi)
+        vst1q_f64 (acc + 2 * i, av);
+    }
+}
+#endif
+
+/********************************************************************************************************
+*                                                                                                       *
+*                                           Block NCO                                                   *
+*                                                                                                       *
+*   out[i] = in[i] * p[i % SHIFT_LANES], with the lane phasors p advanced by rot = exp(j * SHIFT_LANES  *
+*   * delta) after each group of SHIFT_LANES samples (see shift.c).  Interleaved complex; the lane      *
+*   phasors are interleaved, too.  Only whole groups are done, the number of samples done is returned.  *
+*   Selected by init_dotprod() like the dot products.                                                   *
+*                                                                                                       *
+********************************************************************************************************/
+
+static int nco_scalar (double* out, double* in, int n, double* p, double* rot)
+{
+    int i, k;
+    double I, Q, t;
+    for (i = 0; i + SHIFT_LANES <= n; i += SHIFT_LANES)
+    {
+        for (k = 0; k < SHIFT_LANES; k++)
+        {
+            I = in[2 * (i + k) + 0];
+            Q = in[2 * (i + k) + 1];
+            out[2 * (i + k) + 0] = I * p[2 * k + 0] - Q * p[2 * k + 1];
+            out[2 * (i + k) + 1] = I * p[2 * k + 1] + Q * p[2 * k + 0];
+            t = p[2 * k + 0];
+            p[2 * k + 0] = t * rot[0] - p[2 * k + 1] * rot[1];
+            p[2 * k + 1] = t * rot[1] + p[2 * k + 1] * rot[0];
+        }
+    }
+    return i;
+}
+
+#if defined(DOTPROD_AVX2)
+__attribute__((target("avx2,fma")))
+static int nco_avx2 (double* out, double* in, int n, double* p, double* rot)
+{
+    int i, v;
+    __m256d x, pv[SHIFT_LANES / 2];
+    __m256d rr = _mm256_set1_pd (rot[0]);
+    __m256d ri = _mm256_set1_pd (rot[1]);
+    for (v = 0; v < SHIFT_LANES / 2; v++)
+        pv[v] = _mm256_loadu_pd (p + 4 * v);
+    for (i = 0; i + SHIFT_LANES <= n; i += SHIFT_LANES)
+    {
+        for (v = 0; v < SHIFT_LANES / 2; v++)
+        {
+            x = _mm256_loadu_pd (in + 2 * i + 4 * v);
+            // (xr * pr - xi * pi, xi * pr + xr * pi)
+            _mm256_storeu_pd (out + 2 * i + 4 * v, _mm256_fmaddsub_pd (x, _mm256_movedup_pd (pv[v]),
+                _mm256_mul_pd (_mm256_permute_pd (x, 0x5), _mm256_permute_pd (pv[v], 0xF))));
+            pv[v] = _mm256_fmaddsub_pd (pv[v], rr, _mm256_mul_pd (_mm256_permute_pd (pv[v], 0x5), ri));
+        }
+    }
+    for (v = 0; v < SHIFT_LANES / 2; v++)
+        _mm256_storeu_pd (p + 4 * v, pv[v]);
+    return i;
+}
+#endif
+
+#if defined(DOTPROD_NEON)
+static int nco_neon (double* out, double* in, int n, double* p, double* rot)
+{
+    int i, k;
+    const float64x2_t sign = {-1.0, 1.0};
+    float64x2_t x, y, pv[SHIFT_LANES];
+    float64x2_t ri = vmulq_n_f64 (sign, rot[1]);
+    for (k = 0; k < SHIFT_LANES; k++)
+        pv[k] = vld1q_f64 (p + 2 * k);
+    for (i = 0; i + SHIFT_LANES <= n; i += SHIFT_LANES)
+    {
+        for (k = 0; k < SHIFT_LANES; k++)
+        {
+            x = vld1q_f64 (in + 2 * (i + k));
+            y = vmulq_laneq_f64 (x, pv[k], 0);                                                      // (xr * pr, xi * pr)
+            y = vfmaq_f64 (y, vextq_f64 (x, x, 1), vmulq_f64 (vdupq_laneq_f64 (pv[k], 1), sign));   // (-xi * pi, xr * pi)
+            vst1q_f64 (out + 2 * (i + k), y);
+            pv[k] = vfmaq_f64 (vmulq_n_f64 (pv[k], rot[0]), vextq_f64 (pv[k], pv[k], 1), ri);
+        }
+    }
+    for (k = 0; k < SHIFT_LANES; k++)
+        vst1q_f64 (p + 2 * k, pv[k]);
+    return i;
+}
+#endif
+
+void   (*dotprod_cr)  (double* h, double* x, int n, double* I, double* Q) = dotprod_cr_scalar;
+double (*dotprod_rr)  (double* h, double* x, int n) = dotprod_rr_scalar;
+float  (*dotprod_rrf) (float* h, float* x, int n) = dotprod_rrf_scalar;
+double (*dotprod_rre) (double* h, double* x, int n, double* e) = dotprod_rre_scalar;
+void   (*scale_add_rr) (double* w, double* x, int n, double c0, double c1) = scale_add_rr_scalar;
+void   (*dotprod_crf) (float* h, float* x, int n, double* I, double* Q) = dotprod_crf_scalar;
+double (*dotprod_rref) (float* h, float* x, int n, double* e) = dotprod_rref_scalar;
+void   (*scale_add_rrf) (float* w, float* x, int n, double c0, double c1) = scale_add_rrf_scalar;
+void   (*cmac_cc) (double* acc, double* x, double* m, int n) = cmac_scalar;
+int    (*nco_block) (double* out, double* in, int n, double* p, double* rot) = nco_scalar;
+
+void init_dotprod (void)
+{
+    // idempotent, called by the create functions of the users
+#if defined(DOTPROD_AVX2)
+    __builtin_cpu_init ();
+    if (__builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("fma"))
+    {
+        dotprod_cr  = dotprod_cr_avx2;
+        dotprod_rr  = dotprod_rr_avx2;
+        dotprod_rrf = dotprod_rrf_avx2;
+        dotprod_rre = dotprod_rre_avx2;
+        scale_add_rr = scale_add_rr_avx2;
+        dotprod_crf = dotprod_crf_avx2;
+        dotprod_rref = dotprod_rref_avx2;
+        scale_add_rrf = scale_add_rrf_avx2;
+        cmac_cc = cmac_avx2;
+        nco_block = nco_avx2;
+    }
+#elif defined(DOTPROD_NEON)
+    dotprod_cr  = dotprod_cr_neon;
+    dotprod_rr  = dotprod_rr_neon;
+    dotprod_rrf = dotprod_rrf_neon;
+    dotprod_rre = dotprod_rre_neon;
+    scale_add_rr = scale_add_rr_neon;
+    dotprod_crf = dotprod_crf_neon;
+    dotprod_rref = dotprod_rref_neon;
+    scale_add_rrf = scale_add_rrf_neon;
+    cmac_cc = cmac_neon;
+    nco_block = nco_neon;
+#endif
+}
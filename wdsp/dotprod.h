@@ -0,0 +1,68 @@
+/*  dotprod.h
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 the piHPSDR authors
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#ifndef _dotprod_h
+#define _dotprod_h
+
+// sum over j < n of h[j] * x[j], x complex (interleaved), h real; result in *I, *Q
+extern void (*dotprod_cr) (double* h, double* x, int n, double* I, double* Q);
+
+// sum over j < n of h[j] * x[j], all real
+extern double (*dotprod_rr) (double* h, double* x, int n);
+
+// single-precision version of dotprod_rr
+extern float (*dotprod_rrf) (float* h, float* x, int n);
+
+// sum over j < n of h[j] * x[j], all real; the energy of x (sum of x[j] * x[j]) in *e
+extern double (*dotprod_rre) (double* h, double* x, int n, double* e);
+
+// w[j] = c0 * w[j] + c1 * x[j] for j < n (LMS weight update with leakage)
+extern void (*scale_add_rr) (double* w, double* x, int n, double c0, double c1);
+
+// single-precision versions of dotprod_cr, dotprod_rre, scale_add_rr (results and constants in double)
+extern void (*dotprod_crf) (float* h, float* x, int n, double* I, double* Q);
+
+extern double (*dotprod_rref) (float* h, float* x, int n, double* e);
+
+extern void (*scale_add_rrf) (float* w, float* x, int n, double c0, double c1);
+
+// acc[i] += x[i] * m[i] for i < n, all complex (interleaved)
+extern void (*cmac_cc) (double* acc, double* x, double* m, int n);
+
+// block NCO of xshift, out = in times the lane phasors p, advanced by rot (see shift.c);
+// returns the number of samples done, a multiple of SHIFT_LANES
+extern int (*nco_block) (double* out, double* in, int n, double* p, double* rot);
+
+// the versions for the sample type 'real' (see comm.h)
+#ifdef WDSP_REAL_FLOAT
+#define dotprod_cr_real     dotprod_crf
+#define dotprod_rre_real    dotprod_rref
+#define scale_add_rr_real   scale_add_rrf
+#else
+#define dotprod_cr_real     dotprod_cr
+#define dotprod_rre_real    dotprod_rre
+#define scale_add_rr_real   scale_add_rr
+#endif
+
+extern void init_dotprod (void);
+
+#endif
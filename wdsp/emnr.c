@@ -38,122 +38,83 @@ warren@wpratt.com
 //      Bureau of Standards, 1964.
 // Shanjie Zhang and Jianming Jin, "Computation of Special Functions."  New York, NY, John Wiley and Sons,
 //      Inc., 1996.  [Sample code given in FORTRAN]
+// Exponentially scaled, exp(-x) * I0(x) and exp(-x) * I1(x) for x >= 0, both at once:  the gain function
+//      multiplies by exp(-x) anyway, this cancels the exp(x) of the large-argument approximations and
+//      leaves one exp() for the small arguments.
 
-double bessI0 (double x)
+void bessI01e (double x, double* i0e, double* i1e)
 {
-    double res, p;
-    if (x == 0.0)
-        res = 1.0;
-    else
-    {
-        if (x < 0.0) x = -x;
-        if (x <= 3.75)
-        {
-            p = x / 3.75;
-            p = p * p;
-            res = ((((( 0.0045813  * p
+    double p, e;
+    if (x <= 3.75)
+    {
+        p = x / 3.75;
+        p = p * p;
+        e = exp (-x);
+        *i0e = e
+              * ((((((  0.0045813  * p
                       + 0.0360768) * p
                       + 0.2659732) * p
                       + 1.2067492) * p
                       + 3.0899424) * p
                       + 3.5156229) * p
-                      + 1.0;
-        }
-        else
-        {
-            p = 3.75 / x;
-            res = exp (x) / sqrt (x)
-                  * (((((((( + 0.00392377  * p
-                             - 0.01647633) * p
-                             + 0.02635537) * p
-                             - 0.02057706) * p
-                             + 0.00916281) * p
-                             - 0.00157565) * p
-                             + 0.00225319) * p
-                             + 0.01328592) * p
-                             + 0.39894228);
-        }
+                      + 1.0);
+        *i1e = e * x
+              * (((((( 0.00032411  * p
+                     + 0.00301532) * p
+                     + 0.02658733) * p
+                     + 0.15084934) * p
+                     + 0.51498869) * p
+                     + 0.87890594) * p
+                     + 0.5);
     }
-    return res;
-}
-
-double bessI1 (double x)
-{
-
-    double res, p;
-    if (x == 0.0)
-        res = 0.0;
     else
     {
-        if (x < 0.0) x = -x;
-        if (x <= 3.75)
-        {
-            p = x / 3.75;
-            p = p * p;
-            res = x
-                  * (((((( 0.00032411  * p
-                         + 0.00301532) * p
-                         + 0.02658733) * p
-                         + 0.15084934) * p
-                         + 0.51498869) * p
-                         + 0.87890594) * p
-                         + 0.5);
-        }
-        else
-        {
-            p = 3.75 / x;
-            res = exp (x) / sqrt (x)
-                  * (((((((( - 0.00420059  * p
-                             + 0.01787654) * p
-                             - 0.02895312) * p
-                             + 0.02282967) * p
-                             - 0.01031555) * p
-                             + 0.00163801) * p
-                             - 0.00362018) * p
-                             - 0.03988024) * p
-                             + 0.39894228);
-        }
+        p = 3.75 / x;
+        e = 1.0 / sqrt (x);
+        *i0e = e
+              * (((((((( + 0.00392377  * p
+                         - 0.01647633) * p
+                         + 0.02635537) * p
+                         - 0.02057706) * p
+                         + 0.00916281) * p
+                         - 0.00157565) * p
+                         + 0.00225319) * p
+                         + 0.01328592) * p
+                         + 0.39894228);
+        *i1e = e
+              * (((((((( - 0.00420059  * p
+                         + 0.01787654) * p
+                         - 0.02895312) * p
+                         + 0.02282967) * p
+                         - 0.01031555) * p
+                         + 0.00163801) * p
+                         - 0.00362018) * p
+                         - 0.03988024) * p
+                         + 0.39894228);
     }
-    return res;
 }
 
-// EXPONENTIAL INTEGRAL, E1(x)
+// EXPONENTIAL INTEGRAL, E1(x), Polynomial and Rational Approximations
 // M. Abramowitz and I. Stegun, Eds., "Handbook of Mathematical Functions."  Washington, DC:  National
-//      Bureau of Standards, 1964.
-// Shanjie Zhang and Jianming Jin, "Computation of Special Functions."  New York, NY, John Wiley and Sons,
-//      Inc., 1996.  [Sample code given in FORTRAN]
+//      Bureau of Standards, 1964.  Eq. 5.1.53 (0 < x <= 1, |error| < 2.3e-7) and 5.1.56 (x > 1,
+//      |error| < 4e-9).  Replaces the series and continued fraction, which needed up to 100
+//      iterations with two divisions each just above x = 1.
 
-double e1xb (double x)
+double e1xa (double x)
 {
-    double e1, ga, r, t, t0;
-    int k, m;
-    if (x == 0.0)
-        e1 = 1.0e300;
-    else if (x <= 1.0)
-    {
-        e1 = 1.0;
-        r = 1.0;
-
-        for (k = 1; k <= 25; k++)
-        {
-            r = -r * k * x / ((k + 1.0)*(k + 1.0));
-            e1 = e1 + r;
-            if ( fabs (r) <= fabs (e1) * 1.0e-15 )
-                break;
-        }
-
-        ga = 0.5772156649015328;
-        e1 = - ga - log (x) + x * e1;
-    }
-      else
-    {
-        m = 20 + (int)(80.0 / x);
-        t0 = 0.0;
-        for (k = m; k >= 1; k--)
-            t0 = (double)k / (1.0 + k / (x + t0));
-        t = 1.0 / (x + t0);
-        e1 = exp (- x) * t;
-    }
+    double e1;
+    if (x <= 1.0)
+        e1 = - log (x)
+             + (((((  0.00107857  * x
+                    - 0.00976004) * x
+                    + 0.05519968) * x
+                    - 0.24991055) * x
+                    + 0.99999193) * x
+                    - 0.57721566);
+    else
+        e1 = exp (- x) / x
+             * ((((x + 8.5733287401) * x + 18.0590169730) * x + 8.6347608925) * x + 0.2677737343)
+             / ((((x + 9.5733223454) * x + 25.6329561486) * x + 21.0996530827) * x + 3.9584969228);
     return e1;
 }
 
@@ -246,8 +207,8 @@ void calc_emnr(EMNR a)
     a->outaccum = (double *)malloc0(a->oasize * sizeof(double));
     a->nsamps = 0;
     a->saveidx = 0;
-    a->Rfor = fftw_plan_dft_r2c_1d(a->fsize, a->forfftin, (fftw_complex *)a->forfftout, FFTW_ESTIMATE);
-    a->Rrev = fftw_plan_dft_c2r_1d(a->fsize, (fftw_complex *)a->revfftin, a->revfftout, FFTW_ESTIMATE);
+    a->Rfor = create_fftplan_r2c (a->fsize, a->forfftin, a->forfftout);
+    a->Rrev = create_fftplan_c2r (a->fsize, a->revfftin, a->revfftout);
     calc_window(a);
 
     a->g.msize = a->msize;
@@ -272,20 +233,35 @@ void calc_emnr(EMNR a)
         a->g.prev_gamma[i] = 1.0;
     }
     a->g.gmax = 10000.0;
+    a->g.eps_hat = (double *)malloc0(a->msize * sizeof(double));
     //
-    a->g.GG = (double *)malloc0(241 * 241 * sizeof(double));
-    a->g.GGS = (double *)malloc0(241 * 241 * sizeof(double));
-    if ((a->g.fileb = fopen("calculus", "rb")))
-    {
-        fread(a->g.GG, sizeof(double), 241 * 241, a->g.fileb);
-        fread(a->g.GGS, sizeof(double), 241 * 241, a->g.fileb);
-        fclose(a->g.fileb);
-    }
-    else
+    // the tables are kept in float, half the cache footprint; they are interpolated from a 0.25 dB grid
+    a->g.GG = (float *)malloc0(241 * 241 * sizeof(float));
+    a->g.GGS = (float *)malloc0(241 * 241 * sizeof(float));
     {
-        memcpy (a->g.GG,  GG,  241 * 241 * sizeof(double));
-        memcpy (a->g.GGS, GGS, 241 * 241 * sizeof(double));
-    }
+        double* GGd = GG;
+        double* GGSd = GGS;
+        if ((a->g.fileb = fopen("calculus", "rb")))
+        {
+            GGd = (double *)malloc0(2 * 241 * 241 * sizeof(double));
+            GGSd = GGd + 241 * 241;
+            fread(GGd, sizeof(double), 241 * 241, a->g.fileb);
+            fread(GGSd, sizeof(double), 241 * 241, a->g.fileb);
+            fclose(a->g.fileb);
+        }
+        for (i = 0; i < 241 * 241; i++)
+        {
+            a->g.GG[i]  = (float)GGd[i];
+            a->g.GGS[i] = (float)GGSd[i];
+        }
+        if (GGd != GG) _aligned_free(GGd);
+    }
+    a->g.xis_offset = -40.0 * log10(1.0 - a->g.q);
+    a->g.gg_idx = (int *)malloc0(a->msize * sizeof(int));
+    a->g.ggs_idx = (int *)malloc0(a->msize * sizeof(int));
+    a->g.dg = (double *)malloc0(a->msize * sizeof(double));
+    a->g.dx = (double *)malloc0(a->msize * sizeof(double));
+    a->g.dxs = (double *)malloc0(a->msize * sizeof(double));
     //
 
     a->np.incr = a->incr;
@@ -347,6 +323,7 @@ void calc_emnr(EMNR a)
     a->np.sigma2N = (double *)malloc0(a->np.msize * sizeof(double));
     a->np.pbar = (double *)malloc0(a->np.msize * sizeof(double));
     a->np.p2bar = (double *)malloc0(a->np.msize * sizeof(double));
+    a->np.invQeq = (double *)malloc0(a->np.msize * sizeof(double));
     a->np.Qeq = (double *)malloc0(a->np.msize * sizeof(double));
     a->np.bmin = (double *)malloc0(a->np.msize * sizeof(double));
     a->np.bmin_sub = (double *)malloc0(a->np.msize * sizeof(double));
@@ -438,6 +415,7 @@ void decalc_emnr(EMNR a)
     _aligned_free(a->np.bmin_sub);
     _aligned_free(a->np.bmin);
     _aligned_free(a->np.Qeq);
+    _aligned_free(a->np.invQeq);
     _aligned_free(a->np.p2bar);
     _aligned_free(a->np.pbar);
     _aligned_free(a->np.sigma2N);
@@ -445,15 +423,21 @@ void decalc_emnr(EMNR a)
     _aligned_free(a->np.alphaOptHat);
     _aligned_free(a->np.p);
 
+    _aligned_free(a->g.dxs);
+    _aligned_free(a->g.dx);
+    _aligned_free(a->g.dg);
+    _aligned_free(a->g.ggs_idx);
+    _aligned_free(a->g.gg_idx);
     _aligned_free(a->g.GGS);
     _aligned_free(a->g.GG);
+    _aligned_free(a->g.eps_hat);
     _aligned_free(a->g.prev_mask);
     _aligned_free(a->g.prev_gamma);
     _aligned_free(a->g.lambda_d);
     _aligned_free(a->g.lambda_y);
 
-    fftw_destroy_plan(a->Rrev);
-    fftw_destroy_plan(a->Rfor);
+    destroy_fftplan (a->Rrev);
+    destroy_fftplan (a->Rfor);
     _aligned_free(a->outaccum);
     for (i = 0; i < a->ovrlp; i++)
         _aligned_free(a->save[i]);
@@ -524,6 +508,8 @@ void LambdaD(EMNR a)
     double bc;
     double QeqTilda, QeqTildaSub;
     double noise_slope_max;
+    double betamax = a->np.betamax;                         // in locals, the stores to the arrays
+    double invQeqMax = a->np.invQeqMax;                     // could alias the struct
 
     sum_prev_p = 0.0;
     sum_lambda_y = 0.0;
@@ -551,18 +537,25 @@ void LambdaD(EMNR a)
         a->np.alphaHat[k] = f2 * a->np.alphaOptHat[k];
     for (k = 0; k < a->np.msize; k++)
         a->np.p[k] = a->np.alphaHat[k] * a->np.p[k] + (1.0 - a->np.alphaHat[k]) * a->np.lambda_y[k];
-    invQbar = 0.0;
     for (k = 0; k < a->np.msize; k++)
     {
-        beta = min (a->np.betamax, a->np.alphaHat[k] * a->np.alphaHat[k]);
+        beta = min (betamax, a->np.alphaHat[k] * a->np.alphaHat[k]);
         a->np.pbar[k] = beta * a->np.pbar[k] + (1.0 - beta) * a->np.p[k];
         a->np.p2bar[k] = beta * a->np.p2bar[k] + (1.0 - beta) * a->np.p[k] * a->np.p[k];
+    }
+    // the sum of invQeq is taken in a separate loop, so that this one has no loop-carried dependence
+    // and is vectorized
+    for (k = 0; k < a->np.msize; k++)
+    {
         varHat = a->np.p2bar[k] - a->np.pbar[k] * a->np.pbar[k];
         invQeq = varHat / (2.0 * a->np.sigma2N[k] * a->np.sigma2N[k]);
-        if (invQeq > a->np.invQeqMax) invQeq = a->np.invQeqMax;
+        if (invQeq > invQeqMax) invQeq = invQeqMax;
+        a->np.invQeq[k] = invQeq;
         a->np.Qeq[k] = 1.0 / invQeq;
-        invQbar += invQeq;
     }
+    invQbar = 0.0;
+    for (k = 0; k < a->np.msize; k++)
+        invQbar += a->np.invQeq[k];
     invQbar /= (double)a->np.msize;
     bc = 1.0 + a->np.av * sqrt (invQbar);
     for (k = 0; k < a->np.msize; k++)
@@ -654,7 +647,7 @@ void aepf(EMNR a)
 {
     int k, m;
     int N, n;
-    double sumPre, sumPost, zeta, zetaT;
+    double sumPre, sumPost, zeta, zetaT, sum;
     sumPre = 0.0;
     sumPost = 0.0;
     for (k = 0; k < a->ae.msize; k++)
@@ -672,66 +665,43 @@ void aepf(EMNR a)
     else
         N = 1 + 2 * (int)(0.5 + a->ae.psi * (1.0 - zetaT / a->ae.zetaThresh));
     n = N / 2;
+    // moving average as a running sum
+    sum = 0.0;
+    for (m = 0; m < N - 1; m++)
+        sum += a->mask[m];
     for (k = n; k < (a->ae.msize - n); k++)
     {
-        a->ae.nmask[k] = 0.0;
-        for (m = k - n; m <= (k + n); m++)
-            a->ae.nmask[k] += a->mask[m];
-        a->ae.nmask[k] /= (double)N;
+        sum += a->mask[k + n];
+        a->ae.nmask[k] = sum / (double)N;
+        sum -= a->mask[k - n];
     }
     memcpy (a->mask + n, a->ae.nmask, (a->ae.msize - 2 * n) * sizeof (double));
 }
 
-double getKey(double* type, double gamma, double xi)
+// The gain tables have a 0.25 dB grid from 0.001 (index 0) to 1000.0 (index 240) in both gamma and xi.
+// Table position u = 4 * 10 * log10(x / 0.001), split into the lower grid index and the weight of the upper one.
+static inline void table_pos (double u, int* n, double* d)
 {
-    int ngamma1, ngamma2, nxi1, nxi2;
-    double tg, tx, dg, dx;
-    const double dmin = 0.001;
-    const double dmax = 1000.0;
-    if (gamma <= dmin)
-    {
-        ngamma1 = ngamma2 = 0;
-        tg = 0.0;
-    }
-    else if (gamma >= dmax)
-    {
-        ngamma1 = ngamma2 = 240;
-        tg = 60.0;
-    }
-    else
-    {
-        tg = 10.0 * log10(gamma / dmin);
-        ngamma1 = (int)(4.0 * tg);
-        ngamma2 = ngamma1 + 1;
-    }
-    if (xi <= dmin)
-    {
-        nxi1 = nxi2 = 0;
-        tx = 0.0;
-    }
-    else if (xi >= dmax)
-    {
-        nxi1 = nxi2 = 240;
-        tx = 60.0;
-    }
-    else
-    {
-        tx = 10.0 * log10(xi / dmin);
-        nxi1 = (int)(4.0 * tx);
-        nxi2 = nxi1 + 1;
-    }
-    dg = (tg - 0.25 * ngamma1) / 0.25;
-    dx = (tx - 0.25 * nxi1) / 0.25;
-    return (1.0 - dg)  * (1.0 - dx) * type[241 * nxi1 + ngamma1]
-        +  (1.0 - dg)  *        dx  * type[241 * nxi2 + ngamma1]
-        +         dg   * (1.0 - dx) * type[241 * nxi1 + ngamma2]
-        +         dg   *        dx  * type[241 * nxi2 + ngamma2];
+    if (u < 0.0)   u = 0.0;
+    if (u > 240.0) u = 240.0;
+    *n = (int)u;
+    if (*n > 239) *n = 239;
+    *d = u - (double)*n;
+}
+
+// bilinear interpolation; idx = 241 * nxi + ngamma of the lower corner
+double getKey(float* type, int idx, double dg, double dx)
+{
+    float* t = type + idx;
+    double lo = t[0]   + dg * (t[1]   - t[0]);
+    double hi = t[241] + dg * (t[242] - t[241]);
+    return lo + dx * (hi - lo);
 }
 
 void calc_gain (EMNR a)
 {
     int k;
-    for (k = 0; k < a->g.msize; k++)
+    for (k = 0; k < a->msize; k++)
     {
         a->g.lambda_y[k] = a->g.y[2 * k + 0] * a->g.y[2 * k + 0] + a->g.y[2 * k + 1] * a->g.y[2 * k + 1];
     }
@@ -744,19 +714,30 @@ void calc_gain (EMNR a)
         LambdaDs(a);
         break;
     }
+    // a-posteriori SNR gamma and decision-directed a-priori SNR eps_hat for all gain methods;
+    // prev_gamma[] holds the gamma of this frame from here on
+    {
+        double gamma;
+        for (k = 0; k < a->msize; k++)
+        {
+            gamma = min (a->g.lambda_y[k] / a->g.lambda_d[k], a->g.gamma_max);
+            a->g.eps_hat[k] = a->g.alpha * a->g.prev_mask[k] * a->g.prev_mask[k] * a->g.prev_gamma[k]
+                + (1.0 - a->g.alpha) * max (gamma - 1.0, a->g.eps_floor);
+            a->g.prev_gamma[k] = gamma;
+        }
+    }
     switch (a->g.gain_method)
     {
     case 0:
         {
-            double gamma, eps_hat, v;
+            double gamma, eps_hat, v, i0e, i1e;
             for (k = 0; k < a->msize; k++)
             {
-                gamma = min (a->g.lambda_y[k] / a->g.lambda_d[k], a->g.gamma_max);
-                eps_hat = a->g.alpha * a->g.prev_mask[k] * a->g.prev_mask[k] * a->g.prev_gamma[k]
-                    + (1.0 - a->g.alpha) * max (gamma - 1.0, a->g.eps_floor);
+                gamma = a->g.prev_gamma[k];
+                eps_hat = a->g.eps_hat[k];
                 v = (eps_hat / (1.0 + eps_hat)) * gamma;
-                a->g.mask[k] = a->g.gf1p5 * sqrt (v) / gamma * exp (- 0.5 * v)
-                    * ((1.0 + v) * bessI0 (0.5 * v) + v * bessI1 (0.5 * v));
+                bessI01e (0.5 * v, &i0e, &i1e);
+                a->g.mask[k] = a->g.gf1p5 * sqrt (v) / gamma * ((1.0 + v) * i0e + v * i1e);
                 {
                     double v2 = min (v, 700.0);
                     double eta = a->g.mask[k] * a->g.mask[k] * a->g.lambda_y[k] / a->g.lambda_d[k];
@@ -766,39 +747,43 @@ void calc_gain (EMNR a)
                 }
                 if (a->g.mask[k] > a->g.gmax) a->g.mask[k] = a->g.gmax;
                 if (a->g.mask[k] != a->g.mask[k]) a->g.mask[k] = 0.01;
-                a->g.prev_gamma[k] = gamma;
                 a->g.prev_mask[k] = a->g.mask[k];
             }
             break;
         }
     case 1:
         {
-            double gamma, eps_hat, v, ehr;
-            for (k = 0; k < a->g.msize; k++)
+            double eps_hat, v, ehr;
+            for (k = 0; k < a->msize; k++)
             {
-                gamma = min (a->g.lambda_y[k] / a->g.lambda_d[k], a->g.gamma_max);
-                eps_hat = a->g.alpha * a->g.prev_mask[k] * a->g.prev_mask[k] * a->g.prev_gamma[k]
-                    + (1.0 - a->g.alpha) * max (gamma - 1.0, a->g.eps_floor);
+                eps_hat = a->g.eps_hat[k];
                 ehr = eps_hat / (1.0 + eps_hat);
-                v = ehr * gamma;
-                if((a->g.mask[k] = ehr * exp (min (700.0, 0.5 * e1xb(v)))) > a->g.gmax) a->g.mask[k] = a->g.gmax;
+                v = ehr * a->g.prev_gamma[k];
+                if((a->g.mask[k] = ehr * exp (min (700.0, 0.5 * e1xa(v)))) > a->g.gmax) a->g.mask[k] = a->g.gmax;
                 if (a->g.mask[k] != a->g.mask[k])a->g.mask[k] = 0.01;
-                a->g.prev_gamma[k] = gamma;
                 a->g.prev_mask[k] = a->g.mask[k];
             }
             break;
         }
     case 2:
         {
-            double gamma, eps_hat, eps_p;
+            int ng, nx, nxs;
+            double ux;
+            // table positions first (no memory dependence between bins), then the look-ups;
+            // eps_p = eps_hat / (1 - q) is a constant offset on the log grid
+            for (k = 0; k < a->msize; k++)
+            {
+                ux = 40.0 * fast_log10 (a->g.eps_hat[k]) + 120.0;
+                table_pos (40.0 * fast_log10 (a->g.prev_gamma[k]) + 120.0, &ng, &a->g.dg[k]);
+                table_pos (ux, &nx, &a->g.dx[k]);
+                table_pos (ux + a->g.xis_offset, &nxs, &a->g.dxs[k]);
+                a->g.gg_idx[k]  = 241 * nx  + ng;
+                a->g.ggs_idx[k] = 241 * nxs + ng;
+            }
             for (k = 0; k < a->msize; k++)
             {
-                gamma = min(a->g.lambda_y[k] / a->g.lambda_d[k], a->g.gamma_max);
-                eps_hat = a->g.alpha * a->g.prev_mask[k] * a->g.prev_mask[k] * a->g.prev_gamma[k]
-                    + (1.0 - a->g.alpha) * max(gamma - 1.0, a->g.eps_floor);
-                eps_p = eps_hat / (1.0 - a->g.q);
-                a->g.mask[k] = getKey(a->g.GG, gamma, eps_hat) * getKey(a->g.GGS, gamma, eps_p);
-                a->g.prev_gamma[k] = gamma;
+                a->g.mask[k] = getKey(a->g.GG,  a->g.gg_idx[k],  a->g.dg[k], a->g.dx[k])
+                             * getKey(a->g.GGS, a->g.ggs_idx[k], a->g.dg[k], a->g.dxs[k]);
                 a->g.prev_mask[k] = a->g.mask[k];
             }
             break;
@@ -825,7 +810,7 @@ void xemnr (EMNR a, int pos)
                 a->forfftin[i] = a->window[i] * a->inaccum[j];
             a->iaoutidx = (a->iaoutidx + a->incr) % a->iasize;
             a->nsamps -= a->incr;
-            fftw_execute (a->Rfor);
+            xfftplan (a->Rfor);
             calc_gain(a);
             for (i = 0; i < a->msize; i++)
             {
@@ -833,7 +818,7 @@ void xemnr (EMNR a, int pos)
                 a->revfftin[2 * i + 0] = g1 * a->forfftout[2 * i + 0];
                 a->revfftin[2 * i + 1] = g1 * a->forfftout[2 * i + 1];
             }
-            fftw_execute (a->Rrev);
+            xfftplan (a->Rrev);
             for (i = 0; i < a->fsize; i++)
                 a->save[a->saveidx][i] = a->window[i] * a->revfftout[i];
             for (i = a->ovrlp; i > 0; i--)
@@ -60,8 +60,8 @@ typedef struct _emnr
     int oainidx;
     int oaoutidx;
     int saveidx;
-    fftw_plan Rfor;
-    fftw_plan Rrev;
+    FFTPLAN Rfor;
+    FFTPLAN Rrev;
     struct _g
     {
         int gain_method;
@@ -80,9 +80,16 @@ typedef struct _emnr
         double gamma_max;
         double q;
         double gmax;
+        double* eps_hat;        // a-priori SNR estimate of the current frame
         //
-        double* GG;
-        double* GGS;
+        float* GG;              // gain tables, 241 x 241, rows xi, columns gamma
+        float* GGS;
+        double xis_offset;      // table position of eps_hat / (1 - q) relative to eps_hat
+        int* gg_idx;            // interpolation indices and weights of the current frame
+        int* ggs_idx;
+        double* dg;
+        double* dx;
+        double* dxs;
         FILE* fileb;
     } g;
     struct _npest
@@ -107,6 +114,7 @@ typedef struct _emnr
         double* p2bar;
         double invQeqMax;
         double av;
+        double* invQeq;
         double* Qeq;
         int U;
         double Dtime;
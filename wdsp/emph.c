@@ -170,14 +170,14 @@ void calc_emph (EMPH a)
     a->infilt = (double *)malloc0(2 * a->size * sizeof(complex));
     a->product = (double *)malloc0(2 * a->size * sizeof(complex));
     a->mults = fc_mults(a->size, a->f_low, a->f_high, -20.0 * log10(a->f_high / a->f_low), 0.0, a->ctype, a->rate, 1.0 / (2.0 * a->size), 0, 0);
-    a->CFor = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->infilt, (fftw_complex *)a->product, FFTW_FORWARD, FFTW_PATIENT);
-    a->CRev = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->product, (fftw_complex *)a->out, FFTW_BACKWARD, FFTW_PATIENT);
+    a->CFor = create_fftplan_c2c (2 * a->size, a->infilt, a->product, FFTW_FORWARD);
+    a->CRev = create_fftplan_c2c (2 * a->size, a->product, a->out, FFTW_BACKWARD);
 }
 
 void decalc_emph (EMPH a)
 {
-    fftw_destroy_plan(a->CRev);
-    fftw_destroy_plan(a->CFor);
+    destroy_fftplan (a->CRev);
+    destroy_fftplan (a->CFor);
     _aligned_free(a->mults);
     _aligned_free(a->product);
     _aligned_free(a->infilt);
@@ -217,7 +217,7 @@ void xemph (EMPH a, int position)
     if (a->run && a->position == position)
     {
         memcpy (&(a->infilt[2 * a->size]), a->in, a->size * sizeof (complex));
-        fftw_execute (a->CFor);
+        xfftplan (a->CFor);
         for (i = 0; i < 2 * a->size; i++)
         {
             I = a->product[2 * i + 0];
@@ -225,7 +225,7 @@ void xemph (EMPH a, int position)
             a->product[2 * i + 0] = I * a->mults[2 * i + 0] - Q * a->mults[2 * i + 1];
             a->product[2 * i + 1] = I * a->mults[2 * i + 1] + Q * a->mults[2 * i + 0];
         }
-        fftw_execute (a->CRev);
+        xfftplan (a->CRev);
         memcpy (a->infilt, &(a->infilt[2 * a->size]), a->size * sizeof(complex));
     }
     else if (a->in != a->out)
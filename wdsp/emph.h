@@ -95,8 +95,8 @@ typedef struct _emph
     double* product;
     double* mults;
     double rate;
-    fftw_plan CFor;
-    fftw_plan CRev;
+    FFTPLAN CFor;
+    FFTPLAN CRev;
 } emph, *EMPH;
 
 extern EMPH create_emph (int run, int position, int size, double* in, double* out, int rate, int ctype, double f_low, double f_high);
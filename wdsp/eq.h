@@ -104,8 +104,8 @@ typedef struct _eq
     int ctfmode;
     int wintype;
     double samplerate;
-    fftw_plan CFor;
-    fftw_plan CRev;
+    FFTPLAN CFor;
+    FFTPLAN CRev;
 }eq, *EQ;
 
 extern double* eq_mults (int size, int nfreqs, double* F, double* G, double samplerate, double scale, int ctfmode, int wintype);
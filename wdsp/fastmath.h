@@ -0,0 +1,115 @@
+/*  fastmath.h
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 the piHPSDR authors
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+/********************************************************************************************************
+*                                                                                                       *
+*                                         Fast Approximations                                           *
+*                                                                                                       *
+*   Replacements for atan2, cos and sin in the per-sample PLL loops of the demodulators, and for log10  *
+*   in the per-bin gain table look-up of the spectral noise reduction.                                  *
+*   They contain no library calls and no errno handling, so the compiler can inline them and, where     *
+*   the loop allows, vectorize them.  The error bounds below are the maximum found on dense grids       *
+*   against long double references; they include the rounding of the evaluation.                        *
+*                                                                                                       *
+********************************************************************************************************/
+
+#ifndef _fastmath_h
+#define _fastmath_h
+
+// fast_atan2(y, x):  absolute error < 2.5e-10 rad, full range, result in [-pi, pi];
+//                    fast_atan2(0, 0) = 0
+// One division.  The angle is reduced to |t| <= tan(pi/8) by octant symmetry and
+// atan(t) = pi/4 + atan((t - 1) / (t + 1)), then a degree-11 odd minimax polynomial is used.
+static inline double fast_atan2 (double y, double x)
+{
+    const double tan_pi8 = 0.41421356237309504;
+    double ax = fabs (x), ay = fabs (y);
+    double n, d, t, z, z2, r, off = 0.0;
+    int swap = ay > ax;
+    n = swap ? ax : ay;
+    d = swap ? ay : ax;
+    if (n > tan_pi8 * d)
+    {
+        t = n - d;
+        d = n + d;
+        n = t;
+        off = 0.78539816339744831;
+    }
+    if (d == 0.0)
+        return 0.0;
+    t = n / d;
+    z = t * t;
+    z2 = z * z;
+    // Estrin's scheme, shorter dependency chain than Horner's (these run inside PLL loops)
+    r = off + t * ((0.99999999937122819 + z * -0.33333306893048514)
+        + z2 * ((0.19998183041083209 + z * -0.1423953266964898)
+        + z2 * (0.10569828806414196 + z * -0.060263052276572596)));
+    if (swap) r = 1.5707963267948966 - r;
+    if (x < 0.0) r = 3.1415926535897932 - r;
+    return y < 0.0 ? -r : r;
+}
+
+// fast_sincos(x, s, c):  *s = sin(x), *c = cos(x); absolute error < 3e-16 for |x| <= 2*pi,
+//                        growing like |x| * 1e-17 beyond (two-part pi/2 reduction), |x| < 2^31
+// Reduction to |r| <= pi/4 by quadrant, then the sin and cos polynomials of fdlibm's kernels.
+static inline void fast_sincos (double x, double* s, double* c)
+{
+    const double pio2_hi = 1.57079632673412561417e+00;
+    const double pio2_lo = 6.07710050650619224932e-11;
+    int q = (int)(x * 0.63661977236758134 + (x < 0.0 ? -0.5 : 0.5));     // not nearbyint(), a library call
+    double k = (double)q, sr_, cr_;
+    double r = (x - k * pio2_hi) - k * pio2_lo;
+    double z = r * r;
+    double z2 = z * z;
+    double sr = r + r * z * ((-1.66666666666666324348e-01 + z * 8.33333333332248946124e-03)
+        + z2 * ((-1.98412698298579493134e-04 + z * 2.75573137070700676789e-06)
+        + z2 * (-2.50507602534068634195e-08 + z * 1.58969099521155010221e-10)));
+    double cr = 1.0 - 0.5 * z + z2 * ((4.16666666666666019037e-02 + z * -1.38888888888741095749e-03)
+        + z2 * ((2.48015872894767294178e-05 + z * -2.75573143513906633035e-07)
+        + z2 * (2.08757232129817482790e-09 + z * -1.13596475577881948265e-11)));
+    // quadrant, without branches
+    sr_ = (q & 1) ? cr : sr;
+    cr_ = (q & 1) ? sr : cr;
+    *s = (q & 2) ? -sr_ : sr_;
+    *c = ((q + 1) & 2) ? -cr_ : cr_;
+}
+
+// fast_log10(x):  absolute error < 1e-11 for positive normal x; x = 0 gives about -308
+// x = m * 2^e with m in [sqrt(1/2), sqrt(2)) by bit manipulation, then ln(m) = 2 * atanh((m - 1) / (m + 1))
+// by its odd series up to degree 11.
+static inline double fast_log10 (double x)
+{
+    union { double d; long long i; } u;
+    double e, m, s, z, z2;
+    u.d = x;
+    u.i -= 0x3fe6a09e667f3bcdLL;                                        // bits of sqrt(1/2)
+    e = (double)(u.i >> 52);
+    u.i = (u.i & 0x000fffffffffffffLL) + 0x3fe6a09e667f3bcdLL;
+    m = u.d;
+    s = (m - 1.0) / (m + 1.0);
+    z = s * s;
+    z2 = z * z;
+    return 0.43429448190325182 * (e * 0.69314718055994531 + 2.0 * s * ((1.0 + z * 0.33333333333333333)
+        + z2 * ((0.2 + z * 0.14285714285714286) + z2 * (0.11111111111111111 + z * 0.090909090909090909))));
+}
+
+#endif
@@ -0,0 +1,336 @@
+/*  fftplan.c
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 the piHPSDR authors
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+#include "comm.h"
+
+/********************************************************************************************************
+*                                                                                                       *
+*                                       Shared FFTW Plan Cache                                          *
+*                                                                                                       *
+*   All FFTW plans of WDSP are obtained here.  Plans are kept in a process-wide cache, keyed by kind,   *
+*   size, direction, in-place and the alignment of the buffers, and are shared by all instances         *
+*   needing the same transform.  Each instance executes the shared plan on its own buffers through      *
+*   FFTW's new-array execute functions.                                                                 *
+*                                                                                                       *
+*   A new plan is taken from wisdom if possible.  Otherwise an ESTIMATE plan is used for the time       *
+*   being and a background thread computes a PATIENT plan, which then replaces the ESTIMATE plan in     *
+*   the cache.  After serving the transforms actually in use, the background thread works through       *
+*   the standard list of sizes (as WDSPwisdom used to do), then saves the wisdom file.                  *
+*                                                                                                       *
+*   The FFTW planner is not thread-safe, all planning (and wisdom) is serialized by fp.csPlan.          *
+*   Executing a plan is.  fp.cs only protects the cache and is never held while planning, so finding    *
+*   a cached plan does not wait for the background thread.  A plan that is not cached yet waits for     *
+*   at most one background plan, which is limited to FFTPLAN_TIMELIMIT.  Plans that have been replaced  *
+*   may still be executing in another thread, so they are kept in the 'retired' list and never          *
+*   destroyed.                                                                                          *
+*                                                                                                       *
+********************************************************************************************************/
+
+static struct _fp
+{
+    volatile long init;                     // bit 0: initialization started, bit 1: done
+    CRITICAL_SECTION csPlan;                // serializes the FFTW planner, taken before cs
+    CRITICAL_SECTION cs;                    // protects the cache
+    FFTPLAN_ENTRY list;                     // cache
+    FFTPLAN_ENTRY retired;                  // replaced entries (their plans)
+    HANDLE Sem_Pending;                     // a new ESTIMATE plan is waiting for its PATIENT plan
+    volatile long running;                  // background thread started
+    char wisdom_file[1024];
+    int imported;                           // wisdom file was read successfully
+    char status[128];
+} fp;
+
+static void init_fftplan (void)
+{
+    if (!InterlockedBitTestAndSet (&fp.init, 0))
+    {
+        InitializeCriticalSectionAndSpinCount (&fp.csPlan, 2500);
+        InitializeCriticalSectionAndSpinCount (&fp.cs, 2500);
+        fp.Sem_Pending = CreateSemaphore (0, 0, 1000, 0);
+        InterlockedBitTestAndSet (&fp.init, 1);
+    }
+    else
+        while (!(InterlockedAnd (&fp.init, 0xffffffff) & 2))
+            Sleep (1);
+}
+
+static fftw_plan plan_entry (FFTPLAN_ENTRY e, unsigned flags)
+{
+    // plan on scratch buffers with the alignment of the entry; PATIENT planning overwrites the buffers
+    fftw_plan p = NULL;
+    size_t bytes = (e->n + 2) * sizeof (complex);
+    char* ibase = (char *) fftw_malloc (bytes + 64);
+    char* obase = e->inplace ? ibase : (char *) fftw_malloc (bytes + 64);
+    double* in = (double *)(ibase + e->ialign);
+    double* out = (double *)(obase + e->oalign);
+    switch (e->kind)
+    {
+    case FFTPLAN_C2C:
+        p = fftw_plan_dft_1d (e->n, (fftw_complex *)in, (fftw_complex *)out, e->sign, flags);
+        break;
+    case FFTPLAN_R2C:
+        p = fftw_plan_dft_r2c_1d (e->n, in, (fftw_complex *)out, flags);
+        break;
+    case FFTPLAN_C2R:
+        p = fftw_plan_dft_c2r_1d (e->n, (fftw_complex *)in, out, flags);
+        break;
+    }
+    if (!e->inplace) fftw_free (obase);
+    fftw_free (ibase);
+    return p;
+}
+
+static fftw_plan plan_patient (FFTPLAN_ENTRY e)
+{
+    // background only, fp.csPlan held; the time limit is global to FFTW, so it is reset right away
+    fftw_plan p;
+    fftw_set_timelimit (FFTPLAN_TIMELIMIT);
+    p = plan_entry (e, FFTW_PATIENT);
+    fftw_set_timelimit (FFTW_NO_TIMELIMIT);
+    return p;
+}
+
+static FFTPLAN_ENTRY find_entry (int kind, int n, int sign, int inplace, int ialign, int oalign)
+{
+    FFTPLAN_ENTRY e;
+    EnterCriticalSection (&fp.cs);
+    for (e = fp.list; e; e = e->next)
+        if (e->kind == kind && e->n == n && e->sign == sign && e->inplace == inplace
+            && e->ialign == ialign && e->oalign == oalign)
+            break;
+    LeaveCriticalSection (&fp.cs);
+    return e;
+}
+
+static FFTPLAN create_fftplan (int kind, int n, double* in, double* out, int sign)
+{
+    FFTPLAN a = (FFTPLAN) malloc0 (sizeof (fftplan));
+    FFTPLAN_ENTRY e;
+    int ialign = fftw_alignment_of (in);
+    int oalign = fftw_alignment_of (out);
+    int inplace = (in == out);
+    init_fftplan ();
+    a->in = in;
+    a->out = out;
+    if (!(e = find_entry (kind, n, sign, inplace, ialign, oalign)))
+    {
+        EnterCriticalSection (&fp.csPlan);
+        // entries are only added with fp.csPlan held, look again
+        if ((e = find_entry (kind, n, sign, inplace, ialign, oalign)))
+        {
+            LeaveCriticalSection (&fp.csPlan);
+            a->e = e;
+            return a;
+        }
+        e = (FFTPLAN_ENTRY) malloc0 (sizeof (fftplan_entry));
+        e->kind = kind;
+        e->n = n;
+        e->sign = sign;
+        e->inplace = inplace;
+        e->ialign = ialign;
+        e->oalign = oalign;
+        if ((e->plan = plan_entry (e, FFTW_PATIENT | FFTW_WISDOM_ONLY)))
+            e->patient = 1;
+        else
+        {
+            e->plan = plan_entry (e, FFTW_ESTIMATE);
+            ReleaseSemaphore (fp.Sem_Pending, 1, 0);
+        }
+        EnterCriticalSection (&fp.cs);
+        e->next = fp.list;
+        fp.list = e;
+        LeaveCriticalSection (&fp.cs);
+        LeaveCriticalSection (&fp.csPlan);
+    }
+    a->e = e;
+    return a;
+}
+
+FFTPLAN create_fftplan_c2c (int n, double* in, double* out, int sign)
+{
+    return create_fftplan (FFTPLAN_C2C, n, in, out, sign);
+}
+
+FFTPLAN create_fftplan_r2c (int n, double* in, double* out)
+{
+    return create_fftplan (FFTPLAN_R2C, n, in, out, FFTW_FORWARD);
+}
+
+FFTPLAN create_fftplan_c2r (int n, double* in, double* out)
+{
+    return create_fftplan (FFTPLAN_C2R, n, in, out, FFTW_BACKWARD);
+}
+
+void destroy_fftplan (FFTPLAN a)
+{
+    // the shared plan stays in the cache
+    _aligned_free (a);
+}
+
+void xfftplan (FFTPLAN a)
+{
+    fftw_plan p = a->e->plan;
+    switch (a->e->kind)
+    {
+    case FFTPLAN_C2C:
+        fftw_execute_dft (p, (fftw_complex *)a->in, (fftw_complex *)a->out);
+        break;
+    case FFTPLAN_R2C:
+        fftw_execute_dft_r2c (p, a->in, (fftw_complex *)a->out);
+        break;
+    case FFTPLAN_C2R:
+        fftw_execute_dft_c2r (p, (fftw_complex *)a->in, a->out);
+        break;
+    }
+}
+
+/********************************************************************************************************
+*                                                                                                       *
+*                                       Background Wisdom                                               *
+*                                                                                                       *
+********************************************************************************************************/
+
+static const char* kind_name (int kind, int sign)
+{
+    switch (kind)
+    {
+    case FFTPLAN_R2C:
+        return "REAL    FORWARD ";
+    case FFTPLAN_C2R:
+        return "REAL    BACKWARD";
+    default:
+        return sign == FFTW_FORWARD ? "COMPLEX FORWARD " : "COMPLEX BACKWARD";
+    }
+}
+
+static void upgrade_entry (FFTPLAN_ENTRY e)
+{
+    fftw_plan p;
+    FFTPLAN_ENTRY r;
+    sprintf (fp.status, "Planning %s FFT size %d", kind_name (e->kind, e->sign), e->n);
+    EnterCriticalSection (&fp.csPlan);
+    p = plan_patient (e);
+    LeaveCriticalSection (&fp.csPlan);
+    EnterCriticalSection (&fp.cs);
+    if (p)
+    {
+        r = (FFTPLAN_ENTRY) malloc0 (sizeof (fftplan_entry));
+        r->plan = e->plan;
+        r->next = fp.retired;
+        fp.retired = r;
+        e->plan = p;
+    }
+    InterlockedBitTestAndSet (&e->patient, 0);
+    LeaveCriticalSection (&fp.cs);
+}
+
+static void learn_size (int kind, int n, int sign)
+{
+    // standard list: compute the wisdom only, the plan is not needed now
+    fftplan_entry t;
+    memset (&t, 0, sizeof (fftplan_entry));
+    t.kind = kind;
+    t.n = n;
+    t.sign = sign;
+    sprintf (fp.status, "Planning %s FFT size %d", kind_name (kind, sign), n);
+    EnterCriticalSection (&fp.csPlan);
+    if ((t.plan = plan_patient (&t)))
+        fftw_destroy_plan (t.plan);
+    LeaveCriticalSection (&fp.csPlan);
+}
+
+static void fftplan_worker (void* arg)
+{
+    const int maxsize = max (MAX_WISDOM_SIZE_DISPLAY, MAX_WISDOM_SIZE_FILTER + 1);
+    int kind[128], size[128], sign[128];
+    int i, nstd = 0, dirty = 0;
+    int psize;
+    FFTPLAN_ENTRY e;
+    // the sizes WDSPwisdom has always planned
+    for (psize = 64; psize <= MAX_WISDOM_SIZE_FILTER; psize *= 2)
+    {
+        kind[nstd] = FFTPLAN_C2C; size[nstd] = psize;     sign[nstd++] = FFTW_FORWARD;
+        kind[nstd] = FFTPLAN_C2C; size[nstd] = psize;     sign[nstd++] = FFTW_BACKWARD;
+        kind[nstd] = FFTPLAN_C2C; size[nstd] = psize + 1; sign[nstd++] = FFTW_BACKWARD;
+    }
+    for (psize = 64; psize <= MAX_WISDOM_SIZE_DISPLAY; psize *= 2)
+    {
+        if (psize > MAX_WISDOM_SIZE_FILTER)
+        {
+            kind[nstd] = FFTPLAN_C2C; size[nstd] = psize; sign[nstd++] = FFTW_FORWARD;
+        }
+        kind[nstd] = FFTPLAN_R2C; size[nstd] = psize; sign[nstd++] = FFTW_FORWARD;
+    }
+    i = fp.imported ? nstd : 0;
+    if (i < nstd)
+        fprintf (stdout, "Optimizing FFT sizes through %d in the background\n", maxsize);
+    while (1)
+    {
+        // first the transforms in use, newest first
+        EnterCriticalSection (&fp.cs);
+        for (e = fp.list; e && e->patient; e = e->next);
+        LeaveCriticalSection (&fp.cs);
+        if (e)
+            upgrade_entry (e);
+        else if (i < nstd)
+        {
+            learn_size (kind[i], size[i], sign[i]);
+            i++;
+        }
+        else
+        {
+            if (dirty)
+            {
+                EnterCriticalSection (&fp.csPlan);
+                fftw_export_wisdom_to_filename (fp.wisdom_file);
+                LeaveCriticalSection (&fp.csPlan);
+                sprintf (fp.status, "FFTW planning complete.");
+                fprintf (stdout, "FFTW planning complete, wisdom saved.\n");
+                fflush (stdout);
+                dirty = 0;
+            }
+            WaitForSingleObject (fp.Sem_Pending, INFINITE);
+            continue;
+        }
+        dirty = 1;
+    }
+}
+
+void start_fftplan_wisdom (char* wisdom_file)
+{
+    init_fftplan ();
+    if (!InterlockedBitTestAndSet (&fp.running, 0))
+    {
+        strncpy (fp.wisdom_file, wisdom_file, sizeof (fp.wisdom_file) - 1);
+        EnterCriticalSection (&fp.csPlan);
+        fp.imported = fftw_import_wisdom_from_filename (fp.wisdom_file);
+        LeaveCriticalSection (&fp.csPlan);
+        sprintf (fp.status, fp.imported ? "FFTW wisdom loaded." : "Optimizing FFT sizes in the background.");
+        _beginthread (fftplan_worker, 0, NULL);
+    }
+}
+
+char* get_fftplan_status (void)
+{
+    return fp.status;
+}
@@ -0,0 +1,66 @@
+/*  fftplan.h
+
+This file is part of a program that implements a Software-Defined Radio.
+
+Copyright (C) 2026 the piHPSDR authors
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+*/
+
+#ifndef _fftplan_h
+#define _fftplan_h
+
+#define FFTPLAN_C2C             0           // complex to complex, sign FFTW_FORWARD or FFTW_BACKWARD
+#define FFTPLAN_R2C             1           // real to complex (forward)
+#define FFTPLAN_C2R             2           // complex to real (backward)
+
+#define FFTPLAN_TIMELIMIT       2.0         // seconds, upper limit for one background PATIENT plan
+
+typedef struct _fftplan_entry
+{
+    int kind;                               // FFTPLAN_C2C, _R2C, _C2R
+    int n;                                  // transform size
+    int sign;                               // FFTW_FORWARD or FFTW_BACKWARD
+    int inplace;                            // in == out
+    int ialign;                             // fftw_alignment_of() input
+    int oalign;                             // fftw_alignment_of() output
+    fftw_plan volatile plan;                // shared plan, replaced when a better one arrives
+    volatile long patient;                  // 1 if 'plan' is a PATIENT plan
+    struct _fftplan_entry* next;
+} fftplan_entry, *FFTPLAN_ENTRY;
+
+typedef struct _fftplan
+{
+    FFTPLAN_ENTRY e;                        // shared plan
+    double* in;                             // this instance's input buffer
+    double* out;                            // this instance's output buffer
+} fftplan, *FFTPLAN;
+
+extern FFTPLAN create_fftplan_c2c (int n, double* in, double* out, int sign);
+
+extern FFTPLAN create_fftplan_r2c (int n, double* in, double* out);
+
+extern FFTPLAN create_fftplan_c2r (int n, double* in, double* out);
+
+extern void destroy_fftplan (FFTPLAN a);
+
+extern void xfftplan (FFTPLAN a);
+
+extern void start_fftplan_wisdom (char* wisdom_file);
+
+extern char* get_fftplan_status (void);
+
+#endif
@@ -30,13 +30,12 @@ double* fftcv_mults (int NM, double* c_impulse)
 {
     double* mults        = (double *) malloc0 (NM * sizeof (complex));
     double* cfft_impulse = (double *) malloc0 (NM * sizeof (complex));
-    fftw_plan ptmp = fftw_plan_dft_1d(NM, (fftw_complex *) cfft_impulse,
-            (fftw_complex *) mults, FFTW_FORWARD, FFTW_PATIENT);
+    FFTPLAN ptmp = create_fftplan_c2c (NM, cfft_impulse, mults, FFTW_FORWARD);
     memset (cfft_impulse, 0, NM * sizeof (complex));
     // store complex coefs right-justified in the buffer
     memcpy (&(cfft_impulse[NM - 2]), c_impulse, (NM / 2 + 1) * sizeof(complex));
-    fftw_execute (ptmp);
-    fftw_destroy_plan (ptmp);
+    xfftplan (ptmp);
+    destroy_fftplan (ptmp);
     _aligned_free (cfft_impulse);
     return mults;
 }
@@ -88,7 +87,7 @@ double* fir_fsamp_odd (int N, double* A, int rtype, double scale, int wintype)
     double* window;
     double *fcoef     = (double *) malloc0 (N * sizeof (complex));
     double *c_impulse = (double *) malloc0 (N * sizeof (complex));
-    fftw_plan ptmp = fftw_plan_dft_1d(N, (fftw_complex *)fcoef, (fftw_complex *)c_impulse, FFTW_BACKWARD, FFTW_PATIENT);
+    FFTPLAN ptmp = create_fftplan_c2c (N, fcoef, c_impulse, FFTW_BACKWARD);
     double local_scale = 1.0 / (double)N;
     for (i = 0; i <= mid; i++)
     {
@@ -102,8 +101,8 @@ double* fir_fsamp_odd (int N, double* A, int rtype, double scale, int wintype)
         fcoef[2 * i + 0] = + fcoef[2 * (mid - j) + 0];
         fcoef[2 * i + 1] = - fcoef[2 * (mid - j) + 1];
     }
-    fftw_execute (ptmp);
-    fftw_destroy_plan (ptmp);
+    xfftplan (ptmp);
+    destroy_fftplan (ptmp);
     _aligned_free (fcoef);
     window = get_fsamp_window(N, wintype);
     switch (rtype)
@@ -295,11 +294,9 @@ void analytic (int N, double* in, double* out)
     double inv_N = 1.0 / (double)N;
     double two_inv_N = 2.0 * inv_N;
     double* x = (double *) malloc0 (N * sizeof (complex));
-    fftw_plan pfor = fftw_plan_dft_1d (N, (fftw_complex *) in,
-            (fftw_complex *) x, FFTW_FORWARD, FFTW_PATIENT);
-    fftw_plan prev = fftw_plan_dft_1d (N, (fftw_complex *) x,
-            (fftw_complex *) out, FFTW_BACKWARD, FFTW_PATIENT);
-    fftw_execute (pfor);
+    FFTPLAN pfor = create_fftplan_c2c (N, in, x, FFTW_FORWARD);
+    FFTPLAN prev = create_fftplan_c2c (N, x, out, FFTW_BACKWARD);
+    xfftplan (pfor);
     x[0] *= inv_N;
     x[1] *= inv_N;
     for (i = 1; i < N / 2; i++)
@@ -310,9 +307,9 @@ void analytic (int N, double* in, double* out)
     x[N + 0] *= inv_N;
     x[N + 1] *= inv_N;
     memset (&x[N + 2], 0, (N - 2) * sizeof (double));
-    fftw_execute (prev);
-    fftw_destroy_plan (prev);
-    fftw_destroy_plan (pfor);
+    xfftplan (prev);
+    destroy_fftplan (prev);
+    destroy_fftplan (pfor);
     _aligned_free (x);
 }
 
@@ -328,12 +325,10 @@ void mp_imp (int N, double* fir, double* mpfir, int pfactor, int polarity)
     double* impulse = (double *) malloc0 (size * sizeof (complex));
     double* newfreq = (double *) malloc0 (size * sizeof (complex));
     memcpy (firpad, fir, N * sizeof (complex));
-    fftw_plan pfor = fftw_plan_dft_1d (size, (fftw_complex *) firpad,
-            (fftw_complex *) firfreq, FFTW_FORWARD, FFTW_PATIENT);
-    fftw_plan prev = fftw_plan_dft_1d (size, (fftw_complex *) newfreq,
-            (fftw_complex *) impulse, FFTW_BACKWARD, FFTW_PATIENT);
+    FFTPLAN pfor = create_fftplan_c2c (size, firpad, firfreq, FFTW_FORWARD);
+    FFTPLAN prev = create_fftplan_c2c (size, newfreq, impulse, FFTW_BACKWARD);
     // print_impulse("orig_imp.txt", N, fir, 1, 0);
-    fftw_execute (pfor);
+    xfftplan (pfor);
     for (i = 0; i < size; i++)
     {
         mag[i] = sqrt (firfreq[2 * i + 0] * firfreq[2 * i + 0] + firfreq[2 * i + 1] * firfreq[2 * i + 1]) * inv_PN;
@@ -351,14 +346,14 @@ void mp_imp (int N, double* fir, double* mpfir, int pfactor, int polarity)
         else
             newfreq[2 * i + 1] = - mag[i] * sin (ana[2 * i + 1]);
     }
-    fftw_execute (prev);
+    xfftplan (prev);
     if (polarity)
         memcpy (mpfir, &impulse[2 * (pfactor - 1) * N], N * sizeof (complex));
     else
         memcpy (mpfir, impulse, N * sizeof (complex));
     // print_impulse("min_imp.txt", N, mpfir, 1, 0);
-    fftw_destroy_plan (prev);
-    fftw_destroy_plan (pfor);
+    destroy_fftplan (prev);
+    destroy_fftplan (pfor);
     _aligned_free (newfreq);
     _aligned_free (impulse);
     _aligned_free (ana);
@@ -139,17 +139,17 @@ void plan_firopt (FIROPT a)
     a->fftout = (double **) malloc0 (a->nfor * sizeof (double *));
     a->fmask = (double **) malloc0 (a->nfor * sizeof (double *));
     a->maskgen = (double *) malloc0 (2 * a->size * sizeof (complex));
-    a->pcfor = (fftw_plan *) malloc0 (a->nfor * sizeof (fftw_plan));
-    a->maskplan = (fftw_plan *) malloc0 (a->nfor * sizeof (fftw_plan));
+    a->pcfor = (FFTPLAN *) malloc0 (a->nfor * sizeof (FFTPLAN));
+    a->maskplan = (FFTPLAN *) malloc0 (a->nfor * sizeof (FFTPLAN));
     for (i = 0; i < a->nfor; i++)
     {
         a->fftout[i] = (double *) malloc0 (2 * a->size * sizeof (complex));
         a->fmask[i] = (double *) malloc0 (2 * a->size * sizeof (complex));
-        a->pcfor[i] = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->fftin, (fftw_complex *)a->fftout[i], FFTW_FORWARD, FFTW_PATIENT);
-        a->maskplan[i] = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->maskgen, (fftw_complex *)a->fmask[i], FFTW_FORWARD, FFTW_PATIENT);
+        a->pcfor[i] = create_fftplan_c2c (2 * a->size, a->fftin, a->fftout[i], FFTW_FORWARD);
+        a->maskplan[i] = create_fftplan_c2c (2 * a->size, a->maskgen, a->fmask[i], FFTW_FORWARD);
     }
     a->accum = (double *) malloc0 (2 * a->size * sizeof (complex));
-    a->crev = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->accum, (fftw_complex *)a->out, FFTW_BACKWARD, FFTW_PATIENT);
+    a->crev = create_fftplan_c2c (2 * a->size, a->accum, a->out, FFTW_BACKWARD);
 }
 
 void calc_firopt (FIROPT a)
@@ -164,7 +164,7 @@ void calc_firopt (FIROPT a)
         // I right-justified the impulse response => take output from left side of output buff, discard right side
         // Be careful about flipping an asymmetrical impulse response.
         memcpy (&(a->maskgen[2 * a->size]), &(impulse[2 * a->size * i]), a->size * sizeof(complex));
-        fftw_execute (a->maskplan[i]);
+        xfftplan (a->maskplan[i]);
     }
     _aligned_free (impulse);
 }
@@ -184,6 +184,7 @@ FIROPT create_firopt (int run, int position, int size, double* in, double* out,
     a->samplerate = samplerate;
     a->wintype = wintype;
     a->gain = gain;
+    init_dotprod ();
     plan_firopt (a);
     calc_firopt (a);
     return a;
@@ -192,14 +193,14 @@ FIROPT create_firopt (int run, int position, int size, double* in, double* out,
 void deplan_firopt (FIROPT a)
 {
     int i;
-    fftw_destroy_plan (a->crev);
+    destroy_fftplan (a->crev);
     _aligned_free (a->accum);
     for (i = 0; i < a->nfor; i++)
     {
         _aligned_free (a->fftout[i]);
         _aligned_free (a->fmask[i]);
-        fftw_destroy_plan (a->pcfor[i]);
-        fftw_destroy_plan (a->maskplan[i]);
+        destroy_fftplan (a->pcfor[i]);
+        destroy_fftplan (a->maskplan[i]);
     }
     _aligned_free (a->maskplan);
     _aligned_free (a->pcfor);
@@ -228,22 +229,18 @@ void xfiropt (FIROPT a, int pos)
 {
     if (a->run && (a->position == pos))
     {
-        int i, j, k;
+        int j, k;
         memcpy (&(a->fftin[2 * a->size]), a->in, a->size * sizeof (complex));
-        fftw_execute (a->pcfor[a->buffidx]);
+        xfftplan (a->pcfor[a->buffidx]);
         k = a->buffidx;
         memset (a->accum, 0, 2 * a->size * sizeof (complex));
         for (j = 0; j < a->nfor; j++)
         {
-            for (i = 0; i < 2 * a->size; i++)
-            {
-                a->accum[2 * i + 0] += a->fftout[k][2 * i + 0] * a->fmask[j][2 * i + 0] - a->fftout[k][2 * i + 1] * a->fmask[j][2 * i + 1];
-                a->accum[2 * i + 1] += a->fftout[k][2 * i + 0] * a->fmask[j][2 * i + 1] + a->fftout[k][2 * i + 1] * a->fmask[j][2 * i + 0];
-            }
+            cmac_cc (a->accum, a->fftout[k], a->fmask[j], 2 * a->size);
             k = (k + a->idxmask) & a->idxmask;
         }
         a->buffidx = (a->buffidx + 1) & a->idxmask;
-        fftw_execute (a->crev);
+        xfftplan (a->crev);
         memcpy (a->fftin, &(a->fftin[2 * a->size]), a->size * sizeof(complex));
     }
     else if (a->in != a->out)
@@ -301,21 +298,21 @@ void plan_fircore (FIRCORE a)
     a->fmask[0] = (double **) malloc0 (a->nfor * sizeof (double *));
     a->fmask[1] = (double **) malloc0 (a->nfor * sizeof (double *));
     a->maskgen = (double *) malloc0 (2 * a->size * sizeof (complex));
-    a->pcfor = (fftw_plan *) malloc0 (a->nfor * sizeof (fftw_plan));
-    a->maskplan    = (fftw_plan **) malloc0 (2 * sizeof (fftw_plan *));
-    a->maskplan[0] = (fftw_plan *) malloc0 (a->nfor * sizeof (fftw_plan));
-    a->maskplan[1] = (fftw_plan *) malloc0 (a->nfor * sizeof (fftw_plan));
+    a->pcfor = (FFTPLAN *) malloc0 (a->nfor * sizeof (FFTPLAN));
+    a->maskplan    = (FFTPLAN **) malloc0 (2 * sizeof (FFTPLAN *));
+    a->maskplan[0] = (FFTPLAN *) malloc0 (a->nfor * sizeof (FFTPLAN));
+    a->maskplan[1] = (FFTPLAN *) malloc0 (a->nfor * sizeof (FFTPLAN));
     for (i = 0; i < a->nfor; i++)
     {
         a->fftout[i]   = (double *) malloc0 (2 * a->size * sizeof (complex));
         a->fmask[0][i] = (double *) malloc0 (2 * a->size * sizeof (complex));
         a->fmask[1][i] = (double *) malloc0 (2 * a->size * sizeof (complex));
-        a->pcfor[i] = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->fftin, (fftw_complex *)a->fftout[i], FFTW_FORWARD, FFTW_PATIENT);
-        a->maskplan[0][i] = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->maskgen, (fftw_complex *)a->fmask[0][i], FFTW_FORWARD, FFTW_PATIENT);
-        a->maskplan[1][i] = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->maskgen, (fftw_complex *)a->fmask[1][i], FFTW_FORWARD, FFTW_PATIENT);
+        a->pcfor[i] = create_fftplan_c2c (2 * a->size, a->fftin, a->fftout[i], FFTW_FORWARD);
+        a->maskplan[0][i] = create_fftplan_c2c (2 * a->size, a->maskgen, a->fmask[0][i], FFTW_FORWARD);
+        a->maskplan[1][i] = create_fftplan_c2c (2 * a->size, a->maskgen, a->fmask[1][i], FFTW_FORWARD);
     }
     a->accum = (double *) malloc0 (2 * a->size * sizeof (complex));
-    a->crev = fftw_plan_dft_1d(2 * a->size, (fftw_complex *)a->accum, (fftw_complex *)a->out, FFTW_BACKWARD, FFTW_PATIENT);
+    a->crev = create_fftplan_c2c (2 * a->size, a->accum, a->out, FFTW_BACKWARD);
     a->masks_ready = 0;
 }
 
@@ -323,17 +320,23 @@ void calc_fircore (FIRCORE a, int flip)
 {
     // call for change in frequency, rate, wintype, gain
     // must also call after a call to plan_firopt()
-    int i;
+    int i, set;
     if (a->mp)
         mp_imp (a->nc, a->impulse, a->imp, 16, 0);
     else
         memcpy (a->imp, a->impulse, a->nc * sizeof (complex));
+    EnterCriticalSection (&a->update);
+    set = 1 - a->cset;
+    LeaveCriticalSection (&a->update);
+    // xfircore() may still be working with this set if cset has just been flipped
+    while (InterlockedAnd (&a->busy, 0xffffffff) & (1 << set))
+        Sleep (0);
     for (i = 0; i < a->nfor; i++)
     {
         // I right-justified the impulse response => take output from left side of output buff, discard right side
         // Be careful about flipping an asymmetrical impulse response.
         memcpy (&(a->maskgen[2 * a->size]), &(a->imp[2 * a->size * i]), a->size * sizeof(complex));
-        fftw_execute (a->maskplan[1 - a->cset][i]);
+        xfftplan (a->maskplan[set][i]);
     }
     a->masks_ready = 1;
     if (flip)
@@ -354,6 +357,7 @@ FIRCORE create_fircore (int size, double* in, double* out, int nc, int mp, doubl
     a->nc = nc;
     a->mp = mp;
     InitializeCriticalSectionAndSpinCount (&a->update, 2500);
+    init_dotprod ();
     plan_fircore (a);
     a->impulse = (double *) malloc0 (a->nc * sizeof (complex));
     a->imp     = (double *) malloc0 (a->nc * sizeof (complex));
@@ -365,16 +369,16 @@ FIRCORE create_fircore (int size, double* in, double* out, int nc, int mp, doubl
 void deplan_fircore (FIRCORE a)
 {
     int i;
-    fftw_destroy_plan (a->crev);
+    destroy_fftplan (a->crev);
     _aligned_free (a->accum);
     for (i = 0; i < a->nfor; i++)
     {
         _aligned_free (a->fftout[i]);
         _aligned_free (a->fmask[0][i]);
         _aligned_free (a->fmask[1][i]);
-        fftw_destroy_plan (a->pcfor[i]);
-        fftw_destroy_plan (a->maskplan[0][i]);
-        fftw_destroy_plan (a->maskplan[1][i]);
+        destroy_fftplan (a->pcfor[i]);
+        destroy_fftplan (a->maskplan[0][i]);
+        destroy_fftplan (a->maskplan[1][i]);
     }
     _aligned_free (a->maskplan[0]);
     _aligned_free (a->maskplan[1]);
@@ -408,24 +412,23 @@ void flush_fircore (FIRCORE a)
 
 void xfircore (FIRCORE a)
 {
-    int i, j, k;
+    int j, k, cset;
     memcpy (&(a->fftin[2 * a->size]), a->in, a->size * sizeof (complex));
-    fftw_execute (a->pcfor[a->buffidx]);
+    xfftplan (a->pcfor[a->buffidx]);
     k = a->buffidx;
     memset (a->accum, 0, 2 * a->size * sizeof (complex));
     EnterCriticalSection (&a->update);
+    cset = a->cset;
+    InterlockedBitTestAndSet (&a->busy, cset);
+    LeaveCriticalSection (&a->update);
     for (j = 0; j < a->nfor; j++)
     {
-        for (i = 0; i < 2 * a->size; i++)
-        {
-            a->accum[2 * i + 0] += a->fftout[k][2 * i + 0] * a->fmask[a->cset][j][2 * i + 0] - a->fftout[k][2 * i + 1] * a->fmask[a->cset][j][2 * i + 1];
-            a->accum[2 * i + 1] += a->fftout[k][2 * i + 0] * a->fmask[a->cset][j][2 * i + 1] + a->fftout[k][2 * i + 1] * a->fmask[a->cset][j][2 * i + 0];
-        }
+        cmac_cc (a->accum, a->fftout[k], a->fmask[cset][j], 2 * a->size);
         k = (k + a->idxmask) & a->idxmask;
     }
-    LeaveCriticalSection (&a->update);
+    InterlockedBitTestAndReset (&a->busy, cset);
     a->buffidx = (a->buffidx + 1) & a->idxmask;
-    fftw_execute (a->crev);
+    xfftplan (a->crev);
     memcpy (a->fftin, &(a->fftin[2 * a->size]), a->size * sizeof(complex));
 }
 
@@ -102,9 +102,9 @@ typedef struct _firopt
     int buffidx;            // fft out buffer index
     int idxmask;            // mask for index computations
     double* maskgen;        // input for mask generation FFT
-    fftw_plan* pcfor;       // array of forward FFT plans
-    fftw_plan crev;         // reverse fft plan
-    fftw_plan* maskplan;    // plans for frequency domain masks
+    FFTPLAN* pcfor;       // array of forward FFT plans
+    FFTPLAN crev;         // reverse fft plan
+    FFTPLAN* maskplan;    // plans for frequency domain masks
 } firopt, *FIROPT;
 
 extern FIROPT create_firopt (int run, int position, int size, double* in, double* out,
@@ -151,11 +151,12 @@ typedef struct _fircore
     int buffidx;            // fft out buffer index
     int idxmask;            // mask for index computations
     double* maskgen;        // input for mask generation FFT
-    fftw_plan* pcfor;       // array of forward FFT plans
-    fftw_plan crev;         // reverse fft plan
-    fftw_plan** maskplan;   // plans for frequency domain masks
+    FFTPLAN* pcfor;       // array of forward FFT plans
+    FFTPLAN crev;         // reverse fft plan
+    FFTPLAN** maskplan;   // plans for frequency domain masks
     CRITICAL_SECTION update;
     int cset;
+    volatile long busy;     // bit 'cset' is set while xfircore() uses fmask[cset]
     int mp;
     int masks_ready;
 } fircore, *FIRCORE;
@@ -148,28 +148,32 @@ void xfmd (FMD a)
         int i;
         double det, del_out;
         double vco[2], corr[2];
+        // the loop state is kept in locals, the stores to audio could alias the struct
+        double phs = a->phs, omega = a->omega, fil_out = a->fil_out, fmdc = a->fmdc;
         for (i = 0; i < a->size; i++)
         {
             // pll
-            vco[0]  = cos (a->phs);
-            vco[1]  = sin (a->phs);
+            fast_sincos (phs, &vco[1], &vco[0]);
             corr[0] = + a->in[2 * i + 0] * vco[0] + a->in[2 * i + 1] * vco[1];
             corr[1] = - a->in[2 * i + 0] * vco[1] + a->in[2 * i + 1] * vco[0];
-            if ((corr[0] == 0.0) && (corr[1] == 0.0)) corr[0] = 1.0;
-            det = atan2 (corr[1], corr[0]);
-            del_out = a->fil_out;
-            a->omega += a->g2 * det;
-            if (a->omega < a->omega_min) a->omega = a->omega_min;
-            if (a->omega > a->omega_max) a->omega = a->omega_max;
-            a->fil_out = a->g1 * det + a->omega;
-            a->phs += del_out;
-            while (a->phs >= TWOPI) a->phs -= TWOPI;
-            while (a->phs < 0.0) a->phs += TWOPI;
+            det = fast_atan2 (corr[1], corr[0]);
+            del_out = fil_out;
+            omega += a->g2 * det;
+            if (omega < a->omega_min) omega = a->omega_min;
+            if (omega > a->omega_max) omega = a->omega_max;
+            fil_out = a->g1 * det + omega;
+            phs += del_out;
+            while (phs >= TWOPI) phs -= TWOPI;
+            while (phs < 0.0) phs += TWOPI;
             // dc removal, gain, & demod output
-            a->fmdc = a->mtau * a->fmdc + a->onem_mtau * a->fil_out;
-            a->audio[2 * i + 0] = a->again * (a->fil_out - a->fmdc);
+            fmdc = a->mtau * fmdc + a->onem_mtau * fil_out;
+            a->audio[2 * i + 0] = a->again * (fil_out - fmdc);
             a->audio[2 * i + 1] = a->audio[2 * i + 0];
         }
+        a->phs = phs;
+        a->omega = omega;
+        a->fil_out = fil_out;
+        a->fmdc = fmdc;
         // de-emphasis
         xfircore (a->pde);
         // audio filter
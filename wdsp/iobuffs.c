@@ -436,7 +436,12 @@ void destroy_iobuffs (int channel)
     CloseHandle (a->Sem_BuffReady);
     DeleteCriticalSection(&a->r2_ControlSection);
     _aligned_free (a->r2_baseptr);
-    _aligned_free (a->r1_baseptr);
+    if (ch[channel].iob.span >= a->r1_baseptr && ch[channel].iob.span < a->r1_baseptr + 2 * a->r1_active_buffsize)
+        _aligned_free (InterlockedExchangePointer (&ch[channel].iob.retired, a->r1_baseptr));
+    else
+        _aligned_free (a->r1_baseptr);
+    if (ch[channel].iob.span == NULL)                       // channel closed, nothing can hold a span
+        _aligned_free (InterlockedExchangePointer (&ch[channel].iob.retired, NULL));
     _aligned_free (a);
 }
 
@@ -461,11 +466,49 @@ void flush_iobuffs (int channel)
 }
 
 
+static void fexchange0_finish (int channel, IOB a, double* out, int* error)
+{   // queue the samples just written to r1 and fetch the output; called with csEXCH held
+    int n;
+    int doit = 0;
+    if ((a->r1_unqueuedsamps += a->in_size) >= a->r1_outsize)
+    {
+        n = a->r1_unqueuedsamps / a->r1_outsize;
+        ReleaseSemaphore(a->Sem_BuffReady, n, 0);
+        a->r1_unqueuedsamps -= n * a->r1_outsize;
+    }
+    if ((a->r1_inidx += a->in_size) == a->r1_active_buffsize)
+        a->r1_inidx = 0;
+
+    EnterCriticalSection (&a->r2_ControlSection);
+    if (a->r2_havesamps >= a->out_size)
+        doit = 1;
+    if ((a->r2_havesamps -= a->out_size) < 0) a->r2_havesamps = 0;
+    LeaveCriticalSection (&a->r2_ControlSection);
+    if (a->bfo) WaitForSingleObject (a->Sem_OutReady, INFINITE);
+    if (a->bfo || doit)
+        if (_InterlockedAnd (&a->slew.downflag, 1))
+        {
+            downslew0 (a, out);
+            if (!_InterlockedAnd (&a->slew.downflag, 1))
+            {
+                InterlockedBitTestAndReset (&ch[channel].exchange, 0);
+                ReleaseSemaphore(a->Sem_Flush, 1, 0);
+            }
+        }
+        else
+            memcpy (out, a->r2_baseptr + 2 * a->r2_outidx, a->out_size * sizeof (complex));
+    else
+    {
+        memset (out, 0, a->out_size * sizeof (complex));
+        *error += -2;
+    }
+    if ((a->r2_outidx += a->out_size) == a->r2_active_buffsize)
+        a->r2_outidx = 0;
+}
+
 PORT    //double, interleaved I/Q
 void fexchange0 (int channel, double* in, double* out, int* error)
 {
-    int n;
-    int doit = 0;
     IOB a;
     *error = 0;
     if (_InterlockedAnd (&ch[channel].exchange, 1))
@@ -477,40 +520,54 @@ void fexchange0 (int channel, double* in, double* out, int* error)
         else
             memcpy (a->r1_baseptr + 2 * a->r1_inidx, in, a->in_size * sizeof (complex));
                                                                                                             // add check with *error += -1; for case when r1 is full and an overwrite occurs
-        if ((a->r1_unqueuedsamps += a->in_size) >= a->r1_outsize)
-        {
-            n = a->r1_unqueuedsamps / a->r1_outsize;
-            ReleaseSemaphore(a->Sem_BuffReady, n, 0);
-            a->r1_unqueuedsamps -= n * a->r1_outsize;
-        }
-        if ((a->r1_inidx += a->in_size) == a->r1_active_buffsize)
-            a->r1_inidx = 0;
+        fexchange0_finish (channel, a, out, error);
+        LeaveCriticalSection (&ch[channel].csEXCH);
+    }
+}
 
-        EnterCriticalSection (&a->r2_ControlSection);
-        if (a->r2_havesamps >= a->out_size)
-            doit = 1;
-        if ((a->r2_havesamps -= a->out_size) < 0) a->r2_havesamps = 0;
-        LeaveCriticalSection (&a->r2_ControlSection);
-        if (a->bfo) WaitForSingleObject (a->Sem_OutReady, INFINITE);
-        if (a->bfo || doit)
-            if (_InterlockedAnd (&a->slew.downflag, 1))
-            {
-                downslew0 (a, out);
-                if (!_InterlockedAnd (&a->slew.downflag, 1))
-                {
-                    InterlockedBitTestAndReset (&ch[channel].exchange, 0);
-                    ReleaseSemaphore(a->Sem_Flush, 1, 0);
-                }
-            }
-            else
-                memcpy (out, a->r2_baseptr + 2 * a->r2_outidx, a->out_size * sizeof (complex));
-        else
+/********************************************************************************************************
+*                                                                                                       *
+*   Zero-copy input:  fexchange_acquire() returns the place in r1 where the next in_size complex        *
+*   samples go, the caller writes them there and then calls fexchange_commit() instead of               *
+*   fexchange0().  This saves the copy of the input buffer.  Only one thread may acquire/commit for     *
+*   a channel.  The span remains readable (e.g., for the display) until the next fexchange_acquire();   *
+*   if the buffers are rebuilt meanwhile, r1 is retired rather than freed; CloseChannel() frees it.     *
+*   If the buffers have been flushed or rebuilt between acquire and commit, the samples are discarded.  *
+*                                                                                                       *
+********************************************************************************************************/
+
+PORT
+double* fexchange_acquire (int channel)
+{
+    IOB a;
+    double* span = NULL;
+    if (_InterlockedAnd (&ch[channel].exchange, 1))
+    {
+        EnterCriticalSection (&ch[channel].csEXCH);
+        a = ch[channel].iob.pe;
+        span = a->r1_baseptr + 2 * a->r1_inidx;
+        ch[channel].iob.span = span;
+        LeaveCriticalSection (&ch[channel].csEXCH);
+        _aligned_free (InterlockedExchangePointer (&ch[channel].iob.retired, NULL));
+    }
+    return span;
+}
+
+PORT
+void fexchange_commit (int channel, double* out, int* error)
+{
+    IOB a;
+    *error = 0;
+    if (_InterlockedAnd (&ch[channel].exchange, 1))
+    {
+        EnterCriticalSection (&ch[channel].csEXCH);
+        a = ch[channel].iob.pe;
+        if (ch[channel].iob.span == a->r1_baseptr + 2 * a->r1_inidx)
         {
-            memset (out, 0, a->out_size * sizeof (complex));
-            *error += -2;
+            if (_InterlockedAnd (&a->slew.upflag, 1))
+                upslew0 (a, ch[channel].iob.span);      // in-place
+            fexchange0_finish (channel, a, out, error);
         }
-        if ((a->r2_outidx += a->out_size) == a->r2_active_buffsize)
-            a->r2_outidx = 0;
         LeaveCriticalSection (&ch[channel].csEXCH);
     }
 }
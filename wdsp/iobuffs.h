@@ -89,6 +89,12 @@ extern void flush_iobuffs (int channel);
 PORT    // double, interleaved I/Q
 void fexchange0 (int channel, double* in, double* out, int* error);
 
+PORT    // zero-copy input, see iobuffs.c
+double* fexchange_acquire (int channel);
+
+PORT
+void fexchange_commit (int channel, double* out, int* error);
+
 PORT    // separate I/Q buffers
 extern void fexchange2 (int channel, INREAL *Iin, INREAL *Qin, OUTREAL *Iout, OUTREAL *Qout, int* error);
 
@@ -26,6 +26,8 @@ john.d.melton@googlemail.com
 */
 
 #include <errno.h>
+#include <sched.h>
+#include <time.h>
 
 #include "linux_port.h"
 #include "comm.h"
@@ -38,10 +40,264 @@ john.d.melton@googlemail.com
 
 #if defined(linux) || defined(__APPLE__)
 
-void QueueUserWorkItem(void *function,void *context,int flags) {
-    pthread_t t;
-    pthread_create(&t, NULL, function, context);
-    pthread_join(t, NULL);
+//
+// Worker pool for QueueUserWorkItem.
+//
+// This used to create a thread and join it right away, for every single
+// FFT the spectrum analyzer dispatches (see sendbuf() in analyzer.c). Now a
+// fixed number of worker threads is created once, and each work item is
+// queued to one of them (round-robin). The analyzer already treats its work
+// items as asynchronous (pnum_threads, input_busy), so the FFTs for different
+// displays and sub-spans now run in parallel.
+//
+// Each worker has its own queue with its own lock. A worker first takes the
+// oldest item from its own queue and otherwise "steals" one from another
+// worker, so a long FFT on one worker does not hold up the items behind it.
+// "pending" counts the queued items and is what idle workers sleep on. An item
+// is always enqueued before "pending" is incremented, so a worker that has
+// claimed one will find an item in some queue.
+//
+// If all queues are full, the item is executed by the caller, as before.
+//
+
+#define POOL_MAX_THREADS 8
+#define POOL_QUEUE_LEN   64
+
+typedef struct _pool_item
+{
+    DWORD (*function)(void *);
+    void *context;
+} POOL_ITEM;
+
+typedef struct _pool_worker
+{
+    pthread_mutex_t lock;
+    POOL_ITEM item[POOL_QUEUE_LEN];
+    int head;                   // oldest item
+    int count;                  // number of items queued
+    pthread_t thread;
+} POOL_WORKER;
+
+static struct
+{
+    int nthreads;
+    POOL_WORKER worker[POOL_MAX_THREADS];
+    pthread_mutex_t lock;       // protects pending
+    pthread_cond_t cond;
+    int pending;
+    unsigned int next;          // round-robin counter for submission
+    // statistics
+    long long submitted;
+    long long completed;
+    long long stolen;
+    long long inlined;
+    int max_depth;
+    long long exec_ns;
+    long long max_exec_ns;
+} pool;
+
+static pthread_once_t pool_once = PTHREAD_ONCE_INIT;
+
+static int pool_pop (POOL_WORKER *w, POOL_ITEM *item)
+{
+    int rc = 0;
+    pthread_mutex_lock (&w->lock);
+    if (w->count > 0)
+    {
+        *item = w->item[w->head];
+        w->head = (w->head + 1) % POOL_QUEUE_LEN;
+        w->count--;
+        rc = 1;
+    }
+    pthread_mutex_unlock (&w->lock);
+    return rc;
+}
+
+static int pool_push (POOL_WORKER *w, const POOL_ITEM *item)
+{
+    int rc = 0;
+    pthread_mutex_lock (&w->lock);
+    if (w->count < POOL_QUEUE_LEN)
+    {
+        w->item[(w->head + w->count) % POOL_QUEUE_LEN] = *item;
+        w->count++;
+        rc = 1;
+    }
+    pthread_mutex_unlock (&w->lock);
+    return rc;
+}
+
+static long long pool_now_ns (void)
+{
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void pool_execute (const POOL_ITEM *item)
+{
+    long long t0 = pool_now_ns ();
+    item->function (item->context);
+    long long dt = pool_now_ns () - t0;
+    __sync_add_and_fetch (&pool.exec_ns, dt);
+    __sync_add_and_fetch (&pool.completed, 1LL);
+    if (dt > pool.max_exec_ns)
+        pool.max_exec_ns = dt;  // racy, but only a statistic
+}
+
+static void *pool_thread (void *arg)
+{
+    int id = (int)(uintptr_t)arg;
+    POOL_ITEM item;
+    while (1)
+    {
+        pthread_mutex_lock (&pool.lock);
+        while (pool.pending == 0)
+            pthread_cond_wait (&pool.cond, &pool.lock);
+        pool.pending--;
+        pthread_mutex_unlock (&pool.lock);
+        //
+        // We have claimed one item: take it from our own queue, or steal it
+        //
+        while (!pool_pop (&pool.worker[id], &item))
+        {
+            int found = 0;
+            for (int i = 1; i < pool.nthreads; i++)
+            {
+                if (pool_pop (&pool.worker[(id + i) % pool.nthreads], &item))
+                {
+                    __sync_add_and_fetch (&pool.stolen, 1LL);
+                    found = 1;
+                    break;
+                }
+            }
+            if (found)
+                break;
+            sched_yield ();
+        }
+        pool_execute (&item);
+    }
+    return NULL;
+}
+
+//
+// Threads created by WDSP must not inherit the scheduling policy and CPU
+// affinity of the creating thread, which may be a real-time or pinned
+// application thread (e.g. the GUI). They start with the settings the
+// process was started with (e.g. by taskset, chrt or a cpuset), taken
+// when WDSP is loaded, before the application changes any thread; the
+// DSP channel threads then get their policy from SetThreadPriority().
+//
+static struct
+{
+    int valid;
+    int policy;
+    struct sched_param param;
+#ifdef __linux__
+    cpu_set_t cpus;
+#endif
+} orig_sched;
+
+__attribute__((constructor))
+static void snapshot_sched (void)
+{
+    if (pthread_getschedparam (pthread_self (), &orig_sched.policy, &orig_sched.param) != 0)
+        return;
+#ifdef SCHED_RESET_ON_FORK
+    orig_sched.policy &= ~SCHED_RESET_ON_FORK;
+#endif
+#ifdef __linux__
+    if (sched_getaffinity (0, sizeof (orig_sched.cpus), &orig_sched.cpus) != 0)
+        return;
+#endif
+    orig_sched.valid = 1;
+}
+
+static void default_sched_attr (pthread_attr_t* attr)
+{
+    if (!orig_sched.valid)
+        return;
+    (void) pthread_attr_setinheritsched (attr, PTHREAD_EXPLICIT_SCHED);
+    (void) pthread_attr_setschedpolicy (attr, orig_sched.policy);
+    (void) pthread_attr_setschedparam (attr, &orig_sched.param);
+#ifdef __linux__
+    (void) pthread_attr_setaffinity_np (attr, sizeof (orig_sched.cpus), &orig_sched.cpus);
+#endif
+}
+
+static void pool_create (void)
+{
+    pthread_attr_t attr;
+    long ncpu = sysconf (_SC_NPROCESSORS_ONLN);
+    int n = ncpu > 1 ? (int)ncpu - 1 : 1;
+    if (n < 2) n = 2;
+    if (n > POOL_MAX_THREADS) n = POOL_MAX_THREADS;
+    pthread_mutex_init (&pool.lock, NULL);
+    pthread_cond_init (&pool.cond, NULL);
+    pthread_attr_init (&attr);
+    default_sched_attr (&attr);
+    for (int i = 0; i < n; i++)
+    {
+        pthread_mutex_init (&pool.worker[i].lock, NULL);
+        if (pthread_create (&pool.worker[i].thread, &attr, pool_thread, (void *)(uintptr_t)i) != 0)
+        {
+            perror ("WDSP:pool_create");
+            n = i;
+            break;
+        }
+#ifndef __APPLE__
+        (void) pthread_setname_np (pool.worker[i].thread, "WDSP pool");
+#endif
+    }
+    pthread_attr_destroy (&attr);
+    pool.nthreads = n;
+}
+
+void QueueUserWorkItem(DWORD (*function)(void *),void *context,int flags) {
+    POOL_ITEM item;
+    int queued = 0;
+    item.function = function;
+    item.context = context;
+    pthread_once (&pool_once, pool_create);
+    __sync_add_and_fetch (&pool.submitted, 1LL);
+
+    if (pool.nthreads > 0)
+    {
+        unsigned int start = __sync_fetch_and_add (&pool.next, 1U);
+        for (int i = 0; i < pool.nthreads && !queued; i++)
+            queued = pool_push (&pool.worker[(start + i) % pool.nthreads], &item);
+    }
+
+    if (!queued)
+    {
+        __sync_add_and_fetch (&pool.inlined, 1LL);
+        pool_execute (&item);
+        return;
+    }
+
+    pthread_mutex_lock (&pool.lock);
+    pool.pending++;
+    if (pool.pending > pool.max_depth)
+        pool.max_depth = pool.pending;
+    pthread_cond_signal (&pool.cond);
+    pthread_mutex_unlock (&pool.lock);
+}
+
+void WDSPGetWorkerStats (int *threads, int *depth, int *max_depth, long long *submitted,
+    long long *completed, long long *stolen, long long *inlined, double *avg_usec, double *max_usec)
+{
+    pthread_once (&pool_once, pool_create);
+    pthread_mutex_lock (&pool.lock);
+    *depth = pool.pending;
+    *max_depth = pool.max_depth;
+    pthread_mutex_unlock (&pool.lock);
+    *threads = pool.nthreads;
+    *submitted = pool.submitted;
+    *completed = pool.completed;
+    *stolen = pool.stolen;
+    *inlined = pool.inlined;
+    *avg_usec = pool.completed > 0 ? 1.0e-3 * (double)pool.exec_ns / (double)pool.completed : 0.0;
+    *max_usec = 1.0e-3 * (double)pool.max_exec_ns;
 }
 
 void InitializeCriticalSectionAndSpinCount(pthread_mutex_t *mutex,int count) {
@@ -164,9 +420,29 @@ void LinuxResetEvent(sem_t* sem) {
     while (sem_trywait(sem) == 0) ;
 }
 
+//
+// The thread functions passed to _beginthread return void, so they
+// must not be called as pthread start routines directly. They are
+// started through thread_start(), which gets function and argument
+// in a small block that it frees.
+//
+typedef struct _thread_args
+{
+    void (*function)(void *);
+    void *arg;
+} THREAD_ARGS;
+
+static void *thread_start(void *p) {
+    THREAD_ARGS args = *(THREAD_ARGS *)p;
+    free(p);
+    args.function(args.arg);
+    return NULL;
+}
+
 HANDLE _beginthread( void( __cdecl *start_address )( void * ), unsigned stack_size, void *arglist) {
     pthread_t threadid;
     pthread_attr_t  attr;
+    THREAD_ARGS *args;
 
     if (pthread_attr_init(&attr)) {
         return (HANDLE)-1;
@@ -182,7 +458,16 @@ HANDLE _beginthread( void( __cdecl *start_address )( void * ), unsigned stack_si
         return (HANDLE)-1;
     }
 
-    if (pthread_create(&threadid, &attr, (void*(*)(void*))start_address, arglist)) {
+    default_sched_attr(&attr);
+
+    if ((args = malloc(sizeof(THREAD_ARGS))) == NULL) {
+        return (HANDLE)-1;
+    }
+    args->function = start_address;
+    args->arg = arglist;
+
+    if (pthread_create(&threadid, &attr, thread_start, args)) {
+         free(args);
          return (HANDLE)-1;
     }
 
@@ -202,20 +487,61 @@ void _endthread() {
     pthread_exit(NULL);
 }
 
-void SetThreadPriority(HANDLE thread, int priority)  {
 //
-// In Linux, the scheduling priority only affects
-// real-time threads (SCHED_FIFO, SCHED_RR), so this
-// is basically a no-op here.
+// Scheduling policy for the "high priority" WDSP threads (the DSP
+// channel threads and syncbuffs). This is set by the application,
+// see WDSPSetThreadPolicy(). With the default (SCHED_OTHER, no CPU
+// set) SetThreadPriority puts the thread back to the policy and CPU
+// set the process was started with, whatever it may have inherited.
 //
-/*
-    int policy;
-    struct sched_param param;
+static int wdsp_sched_policy = SCHED_OTHER;
+static int wdsp_sched_priority = 0;
+static unsigned int wdsp_cpus = 0;
+
+void WDSPSetThreadPolicy(int policy, int priority, unsigned int cpus) {
+    wdsp_sched_policy = policy;
+    wdsp_sched_priority = priority;
+    wdsp_cpus = cpus;
+}
 
-    pthread_getschedparam(thread, &policy, &param);
-    param.sched_priority = sched_get_priority_max(policy);
-    pthread_setschedparam(thread, policy, &param);
-*/
+void SetThreadPriority(HANDLE thread, int priority)  {
+    pthread_t t = (pthread_t) thread;
+    int rc = 0;
+    // priority (THREAD_PRIORITY_HIGHEST) is ignored, the policy decides
+    if (wdsp_sched_policy != SCHED_OTHER) {
+        struct sched_param param;
+        param.sched_priority = wdsp_sched_priority;
+        rc = pthread_setschedparam(t, wdsp_sched_policy, &param);
+    } else if (orig_sched.valid) {
+        rc = pthread_setschedparam(t, orig_sched.policy, &orig_sched.param);
+    }
+    if (rc != 0) {
+        static int warned = 0;
+        if (!warned) {
+            fprintf(stderr, "WDSP: WARNING: cannot set real-time scheduling (%s), using default\n", strerror(rc));
+            warned = 1;
+        }
+    }
+#ifdef __linux__
+    rc = 0;
+    if (wdsp_cpus != 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int i = 0; i < 32; i++) {
+            if (wdsp_cpus & (1U << i)) CPU_SET(i, &set);
+        }
+        rc = pthread_setaffinity_np(t, sizeof(set), &set);
+    } else if (orig_sched.valid) {
+        rc = pthread_setaffinity_np(t, sizeof(orig_sched.cpus), &orig_sched.cpus);
+    }
+    if (rc != 0) {
+        static int warned = 0;
+        if (!warned) {
+            fprintf(stderr, "WDSP: WARNING: cannot set CPU affinity (%s)\n", strerror(rc));
+            warned = 1;
+        }
+    }
+#endif
 }
 
 void CloseHandle(HANDLE hObject) {
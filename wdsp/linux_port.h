@@ -54,6 +54,7 @@ john.d.melton@googlemail.com
 #define InterlockedBitTestAndReset(base,bit) __sync_fetch_and_and(base,~(1L<<bit))
 
 #define InterlockedExchange(target,value) __sync_lock_test_and_set(target,value)
+#define InterlockedExchangePointer(target,value) __sync_lock_test_and_set(target,value)
 #define InterlockedAnd(base,mask) __sync_fetch_and_and(base,mask)
 #define _InterlockedAnd(base,mask) __sync_fetch_and_and(base,mask)
 #define __declspec(x)
@@ -85,7 +86,7 @@ void my_free(void *p);
 
 #define INFINITE -1
 
-void QueueUserWorkItem(void *function,void *context,int flags);
+void QueueUserWorkItem(DWORD (*function)(void *),void *context,int flags);
 
 void InitializeCriticalSectionAndSpinCount(pthread_mutex_t *mutex,int count);
 
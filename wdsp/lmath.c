@@ -90,17 +90,51 @@ void trI (
         }
 }
 
+// Solves T x = b, T the symmetric Toeplitz matrix with first column r[0 .. n-1], by Levinson's recursion
+// in O(n^2) without forming T or its inverse.  T must be positive definite and banded, r[i] = 0 for i > m.
+// Work space w[2 * n].
+void trsolve (int n, int m, double* r, double* b, double* x, double* w)
+{
+    int i, j, k, q;
+    double alpha, beta, mu, scale, t;
+    double* y  = w;                                 // Yule-Walker solution of the current order
+    double* rr = w + n;                             // rr[n - i] = r[i] / r[0], reversed for dotprod_rr()
+    scale = 1.0 / r[0];
+    for (i = 1; i < n; i++)
+        rr[n - i] = (i <= m) ? r[i] * scale : 0.0;
+    x[0] = b[0] * scale;
+    if (n == 1) return;
+    y[0] = alpha = -rr[n - 1];
+    beta = 1.0;
+    for (k = 1; k < n; k++)
+    {
+        q = min (k, m);
+        beta *= 1.0 - alpha * alpha;
+        mu = (b[k] * scale - dotprod_rr (rr + n - q, x + k - q, q)) / beta;
+        for (i = 0, j = k - 1; i < k; i++, j--)
+            x[i] += mu * y[j];
+        x[k] = mu;
+        if (k < n - 1)
+        {
+            alpha = - (rr[n - k - 1] + dotprod_rr (rr + n - q, y + k - q, q)) / beta;
+            for (i = 0, j = k - 1; i <= j; i++, j--)
+            {
+                t = y[j] + alpha * y[i];
+                y[i] += alpha * y[j];
+                y[j] = t;
+            }
+            y[k] = alpha;
+        }
+    }
+}
+
 void asolve(int xsize, int asize, double* x, double* a, double* r, double* z)
 {
     int i, j, k;
     double beta, alpha, t;
-    memset(r, 0, (asize + 1) * sizeof(double));     // work space
     memset(z, 0, (asize + 1) * sizeof(double));     // work space
     for (i = 0; i <= asize; i++)
-    {
-        for (j = 0; j < xsize; j++)
-            r[i] += x[j] * x[j - i];
-    }
+        r[i] = dotprod_rr (x, x - i, xsize);        // x[-asize .. -1] must be readable
     z[0] = 1.0;
     beta = r[0];
     for (k = 0; k < asize; k++)
@@ -35,6 +35,8 @@ extern void trI (
     double* dR_z
     );
 
+extern void trsolve (int n, int m, double* r, double* b, double* x, double* w);
+
 extern void asolve(int xsize, int asize, double* x, double* a, double* r, double* z);
 
 extern void median(int n, double* a, double* med);
@@ -33,6 +33,8 @@ void wdspmain (void *pargs)
     HANDLE hTask = AvSetMmThreadCharacteristics(TEXT("Pro Audio"), &taskIndex);
     if (hTask != 0) AvSetMmThreadPriority(hTask, 2);
     else SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST);
+#else
+    SetThreadPriority((HANDLE) pthread_self(), THREAD_PRIORITY_HIGHEST);
 #endif
 
     int channel = (int)(uintptr_t)pargs;
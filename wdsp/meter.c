@@ -26,6 +26,73 @@ warren@wpratt.com
 
 #include "comm.h"
 
+/********************************************************************************************************
+*                                                                                                       *
+*                                           Result Publication                                          *
+*                                                                                                       *
+*   The results of all meters of a channel share one sequence count (seqlock).  The DSP thread makes    *
+*   the count odd, stores the results and makes it even again; it never waits for a reader.  A reader   *
+*   copies the results and retries if the count was odd or has changed meanwhile.  The meters of a      *
+*   channel are only written from its DSP thread or under its csDSP lock, so there is one writer.       *
+*                                                                                                       *
+********************************************************************************************************/
+
+static inline void begin_write_meter (long* seq)
+{
+    __atomic_fetch_add (seq, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence (__ATOMIC_RELEASE);
+}
+
+static inline void end_write_meter (long* seq)
+{
+    __atomic_fetch_add (seq, 1, __ATOMIC_RELEASE);
+}
+
+// Called by a reader each time it has to wait for the writer.  The writer holds the count for a few stores
+// only, so first spin; if it has been preempted inside its window, let it run.  A yield only helps if it has
+// the same priority: a real-time reader on the writer's CPU must sleep, or neither of them makes progress.
+static inline void wait_meter (int* spins)
+{
+    ++*spins;
+    if (*spins <= 256)
+        return;
+    if (*spins <= 264)
+    {
+#ifdef _WIN32
+        Sleep (0);
+#else
+        sched_yield ();
+#endif
+    }
+    else
+        Sleep (1);
+}
+
+static void read_meters (long* seq, double* result, double* copy, int first, int n)
+{
+    int i;
+    int spins = 0;
+    long s0, s1;
+    while (1)
+    {
+        while ((s0 = __atomic_load_n (seq, __ATOMIC_ACQUIRE)) & 1)
+            wait_meter (&spins);
+        for (i = first; i < first + n; i++)
+            copy[i - first] = ((volatile double*)result)[i];
+        __atomic_thread_fence (__ATOMIC_ACQUIRE);
+        s1 = __atomic_load_n (seq, __ATOMIC_RELAXED);
+        if (s0 == s1)
+            break;
+        wait_meter (&spins);
+    }
+}
+
+/********************************************************************************************************
+*                                                                                                       *
+*                                                   Meter                                               *
+*                                                                                                       *
+********************************************************************************************************/
+
 void calc_meter (METER a)
 {
     a->mult_average = exp(-1.0 / (a->rate * a->tau_average));
@@ -33,7 +100,7 @@ void calc_meter (METER a)
     flush_meter(a);
 }
 
-METER create_meter (int run, int* prun, int size, double* buff, int rate, double tau_av, double tau_decay, double* result, CRITICAL_SECTION** pmtupdate, int enum_av, int enum_pk, int enum_gain, double* pgain)
+METER create_meter (int run, int* prun, int size, double* buff, int rate, double tau_av, double tau_decay, double* result, long* pseq, int enum_av, int enum_pk, int enum_gain, double* pgain)
 {
     METER a = (METER) malloc0 (sizeof (meter));
     a->run = run;
@@ -44,21 +111,17 @@ METER create_meter (int run, int* prun, int size, double* buff, int rate, double
     a->tau_average = tau_av;
     a->tau_peak_decay = tau_decay;
     a->result = result;
+    a->pseq = pseq;
     a->enum_av = enum_av;
     a->enum_pk = enum_pk;
     a->enum_gain = enum_gain;
     a->pgain = pgain;
     calc_meter(a);
-    InitializeCriticalSectionAndSpinCount (&a->mtupdate, 2500);
-    pmtupdate[enum_av]   = &a->mtupdate;
-    pmtupdate[enum_pk]   = &a->mtupdate;
-    pmtupdate[enum_gain] = &a->mtupdate;
     return a;
 }
 
 void destroy_meter (METER a)
 {
-    DeleteCriticalSection (&a->mtupdate);
     _aligned_free (a);
 }
 
@@ -66,16 +129,17 @@ void flush_meter (METER a)
 {
     a->avg  = 0.0;
     a->peak = 0.0;
+    begin_write_meter (a->pseq);
     a->result[a->enum_av] = -400.0;
     a->result[a->enum_pk] = -400.0;
     if ((a->pgain != 0) && (a->enum_gain >= 0))
         a->result[a->enum_gain] = -400.0;
+    end_write_meter (a->pseq);
 }
 
 void xmeter (METER a)
 {
     int srun;
-    EnterCriticalSection (&a->mtupdate);
     if (a->prun != 0)
         srun = *(a->prun);
     else
@@ -85,6 +149,7 @@ void xmeter (METER a)
         int i;
         double smag;
         double np = 0.0;
+        double av, pk, gain = 0.0;
         for (i = 0; i < a->size; i++)
         {
             smag = a->buff[2 * i + 0] * a->buff[2 * i + 0] + a->buff[2 * i + 1] * a->buff[2 * i + 1];
@@ -93,18 +158,26 @@ void xmeter (METER a)
             if (smag > np) np = smag;
         }
         if (np > a->peak) a->peak = np;
-        a->result[a->enum_av] = 10.0 * mlog10 (a->avg + 1.0e-40);
-        a->result[a->enum_pk] = 10.0 * mlog10 (a->peak + 1.0e-40);
+        // compute first, so that the results are published with a few stores
+        av = 10.0 * mlog10 (a->avg + 1.0e-40);
+        pk = 10.0 * mlog10 (a->peak + 1.0e-40);
         if ((a->pgain != 0) && (a->enum_gain >= 0))
-            a->result[a->enum_gain] = 20.0 * mlog10 (*a->pgain + 1.0e-40);
+            gain = 20.0 * mlog10 (*a->pgain + 1.0e-40);
+        begin_write_meter (a->pseq);
+        a->result[a->enum_av] = av;
+        a->result[a->enum_pk] = pk;
+        if ((a->pgain != 0) && (a->enum_gain >= 0))
+            a->result[a->enum_gain] = gain;
+        end_write_meter (a->pseq);
     }
     else
     {
+        begin_write_meter (a->pseq);
         if (a->enum_av   >= 0) a->result[a->enum_av]   = - 400.0;
         if (a->enum_pk   >= 0) a->result[a->enum_pk]   = - 400.0;
         if (a->enum_gain >= 0) a->result[a->enum_gain] = +   0.0;
+        end_write_meter (a->pseq);
     }
-    LeaveCriticalSection (&a->mtupdate);
 }
 
 void setBuffers_meter (METER a, double* in)
@@ -134,13 +207,17 @@ PORT
 double GetRXAMeter (int channel, int mt)
 {
     double val;
-    CRITICAL_SECTION* a = rxa[channel].pmtupdate[mt];
-    EnterCriticalSection (a);
-    val = rxa[channel].meter[mt];
-    LeaveCriticalSection (a);
+    read_meters (&rxa[channel].mtseq, rxa[channel].meter, &val, mt, 1);
     return val;
 }
 
+// all RXA meters at once, all[] has RXA_METERTYPE_LAST elements
+PORT
+void GetRXAMeters (int channel, double* all)
+{
+    read_meters (&rxa[channel].mtseq, rxa[channel].meter, all, 0, RXA_METERTYPE_LAST);
+}
+
 /********************************************************************************************************
 *                                                                                                       *
 *                                           TXA Properties                                              *
@@ -151,9 +228,13 @@ PORT
 double GetTXAMeter (int channel, int mt)
 {
     double val;
-    CRITICAL_SECTION* a = txa[channel].pmtupdate[mt];
-    EnterCriticalSection (a);
-    val = txa[channel].meter[mt];
-    LeaveCriticalSection (a);
+    read_meters (&txa[channel].mtseq, txa[channel].meter, &val, mt, 1);
     return val;
 }
+
+// all TXA meters at once, all[] has TXA_METERTYPE_LAST elements
+PORT
+void GetTXAMeters (int channel, double* all)
+{
+    read_meters (&txa[channel].mtseq, txa[channel].meter, all, 0, TXA_METERTYPE_LAST);
+}
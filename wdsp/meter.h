@@ -45,10 +45,10 @@ typedef struct _meter
     double* pgain;
     double avg;
     double peak;
-    CRITICAL_SECTION mtupdate;
+    long* pseq;         // sequence count of the result vector, odd while it is written
 } meter, *METER;
 
-extern METER create_meter (int run, int* prun, int size, double* buff, int rate, double tau_av, double tau_decay, double* result, CRITICAL_SECTION** pmtupdate, int enum_av, int enum_pk, int enum_gain, double* pgain);
+extern METER create_meter (int run, int* prun, int size, double* buff, int rate, double tau_av, double tau_decay, double* result, long* pseq, int enum_av, int enum_pk, int enum_gain, double* pgain);
 
 extern void destroy_meter (METER a);
 
@@ -66,8 +66,12 @@ extern void setSize_meter (METER a, int size);
 
 extern __declspec (dllexport) double GetRXAMeter (int channel, int mt);
 
+extern __declspec (dllexport) void GetRXAMeters (int channel, double* all);
+
 // TXA Properties
 
 extern __declspec (dllexport) double GetTXAMeter (int channel, int mt);
 
+extern __declspec (dllexport) void GetTXAMeters (int channel, double* all);
+
 #endif
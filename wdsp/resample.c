@@ -64,14 +64,14 @@ void calc_resample (RESAMPLE a)
     if (a->ncoef == 0) a->ncoef = (int)(140.0 * full_rate / min_rate);
     a->ncoef = (a->ncoef / a->L + 1) * a->L;
     a->cpp = a->ncoef / a->L;
-    a->h = (double *)malloc0(a->ncoef * sizeof(double));
+    a->h = (real *)malloc0(a->ncoef * sizeof(real));
     impulse = fir_bandpass(a->ncoef, fc_norm_low, fc_norm_high, 1.0, 1, 0, a->gain * (double)a->L);
     i = 0;
     for (j = 0; j < a->L; j++)
         for (k = 0; k < a->ncoef; k += a->L)
-            a->h[i++] = impulse[j + k];
+            a->h[i++] = (real)impulse[j + k];
     a->ringsize = a->cpp;
-    a->ring = (double *)malloc0(a->ringsize * sizeof(complex));
+    a->ring = (real *)malloc0(4 * a->ringsize * sizeof(real));          // mirrored, see xresample()
     a->idx_in = a->ringsize - 1;
     a->phnum = 0;
     _aligned_free(impulse);
@@ -98,6 +98,7 @@ RESAMPLE create_resample ( int run, int size, double* in, double* out, int in_ra
     a->fc_low = -1.0;       // could add to create_resample() parameters
     a->ncoefin = ncoef;
     a->gain = gain;
+    init_dotprod ();
     calc_resample (a);
     return a;
 }
@@ -112,7 +113,7 @@ void destroy_resample (RESAMPLE a)
 PORT
 void flush_resample (RESAMPLE a)
 {
-    memset (a->ring, 0, a->ringsize * sizeof (complex));
+    memset (a->ring, 0, 4 * a->ringsize * sizeof (real));
     a->idx_in = a->ringsize - 1;
     a->phnum = 0;
 }
@@ -123,25 +124,20 @@ int xresample (RESAMPLE a)
     int outsamps = 0;
     if (a->run)
     {
-        int i, j, n;
-        int idx_out;
+        int i;
+        real* r;
         double I, Q;
 
         for (i = 0; i < a->size; i++)
         {
-            a->ring[2 * a->idx_in + 0] = a->in[2 * i + 0];
-            a->ring[2 * a->idx_in + 1] = a->in[2 * i + 1];
+            // each sample is stored twice, ringsize apart, so that the taps
+            // of a phase are always one contiguous span starting at idx_in
+            r = a->ring + 2 * a->idx_in;
+            r[0] = r[2 * a->ringsize + 0] = (real)a->in[2 * i + 0];
+            r[1] = r[2 * a->ringsize + 1] = (real)a->in[2 * i + 1];
             while (a->phnum < a->L)
             {
-                I = 0.0;
-                Q = 0.0;
-                n = a->cpp * a->phnum;
-                for (j = 0; j < a->cpp; j++)
-                {
-                    if ((idx_out = a->idx_in + j) >= a->ringsize) idx_out -= a->ringsize;
-                    I += a->h[n + j] * a->ring[2 * idx_out + 0];
-                    Q += a->h[n + j] * a->ring[2 * idx_out + 1];
-                }
+                dotprod_cr_real (a->h + a->cpp * a->phnum, r, a->cpp, &I, &Q);
                 a->out[2 * outsamps + 0] = I;
                 a->out[2 * outsamps + 1] = Q;
                 outsamps++;
@@ -247,6 +243,7 @@ RESAMPLEF create_resampleF ( int run, int size, float* in, float* out, int in_ra
     a->size = size;
     a->in = in;
     a->out = out;
+    init_dotprod ();
     x = in_rate;
     y = out_rate;
     while (y != 0)
@@ -265,14 +262,14 @@ RESAMPLEF create_resampleF ( int run, int size, float* in, float* out, int in_ra
     a->ncoef = (int)(60.0 / fc_norm);
     a->ncoef = (a->ncoef / a->L + 1) * a->L;
     a->cpp = a->ncoef / a->L;
-    a->h = (double *) malloc0 (a->ncoef * sizeof (double));
+    a->h = (float *) malloc0 (a->ncoef * sizeof (float));
     impulse = fir_bandpass (a->ncoef, -fc_norm, +fc_norm, 1.0, 1, 0, (double)a->L);
     i = 0;
     for (j = 0; j < a->L; j ++)
         for (k = 0; k < a->ncoef; k += a->L)
-            a->h[i++] = impulse[j + k];
+            a->h[i++] = (float)impulse[j + k];
     a->ringsize = a->cpp;
-    a->ring = (double *) malloc0 (a->ringsize * sizeof (double));
+    a->ring = (float *) malloc0 (2 * a->ringsize * sizeof (float));     // mirrored, see xresample()
     a->idx_in = a->ringsize - 1;
     a->phnum = 0;
     _aligned_free (impulse);
@@ -288,7 +285,7 @@ void destroy_resampleF (RESAMPLEF a)
 
 void flush_resampleF (RESAMPLEF a)
 {
-    memset (a->ring, 0, a->ringsize * sizeof (double));
+    memset (a->ring, 0, 2 * a->ringsize * sizeof (float));
     a->idx_in = a->ringsize - 1;
     a->phnum = 0;
 }
@@ -298,24 +295,15 @@ int xresampleF (RESAMPLEF a)
     int outsamps = 0;
     if (a->run)
     {
-        int i, j, n;
-        int idx_out;
-        double I;
+        int i;
 
         for (i = 0; i < a->size; i++)
         {
-            a->ring[a->idx_in] = (double)a->in[i];
+            a->ring[a->idx_in] = a->ring[a->idx_in + a->ringsize] = a->in[i];
 
             while (a->phnum < a->L)
             {
-                I = 0.0;
-                n = a->cpp * a->phnum;
-                for (j = 0; j < a->cpp; j++)
-                {
-                    if ((idx_out = a->idx_in + j) >= a->ringsize) idx_out -= a->ringsize;
-                    I += a->h[n + j] * a->ring[idx_out];
-                }
-                a->out[outsamps] = (float)I;
+                a->out[outsamps] = dotprod_rrf (a->h + a->cpp * a->phnum, a->ring + a->idx_in, a->cpp);
 
                 outsamps++;
                 a->phnum += a->M;
@@ -50,9 +50,9 @@ typedef struct _resample
     int ncoef;          // number of coefficients
     int L;              // interpolation factor
     int M;              // decimation factor
-    double* h;          // coefficients
+    real* h;            // coefficients
     int ringsize;       // number of complex pairs the ring buffer holds
-    double* ring;       // ring buffer
+    real* ring;         // ring buffer, stored twice
     int cpp;            // coefficients of the phase
     int phnum;          // phase number
 } resample, *RESAMPLE;
@@ -102,9 +102,9 @@ typedef struct _resampleF
     int ncoef;          // number of coefficients
     int L;              // interpolation factor
     int M;              // decimation factor
-    double* h;          // coefficients
+    float* h;           // coefficients
     int ringsize;       // number of values the ring buffer holds
-    double* ring;       // ring buffer
+    float* ring;        // ring buffer, stored twice
     int cpp;            // coefficients of the phase
     int phnum;          // phase number
 } resampleF, *RESAMPLEF;
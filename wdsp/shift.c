@@ -26,11 +26,23 @@ warren@wpratt.com
 
 #include "comm.h"
 
+/********************************************************************************************************
+*                                                                                                       *
+*                                           Frequency Shifter                                           *
+*                                                                                                       *
+********************************************************************************************************/
+
 void calc_shift (SHIFT a)
 {
+    int k;
     a->delta = TWOPI * a->shift / a->rate;
-    a->cos_delta = cos (a->delta);
-    a->sin_delta = sin (a->delta);
+    for (k = 0; k < SHIFT_LANES; k++)
+    {
+        a->lane[2 * k + 0] = cos (k * a->delta);
+        a->lane[2 * k + 1] = sin (k * a->delta);
+    }
+    a->rot[0] = cos (SHIFT_LANES * a->delta);
+    a->rot[1] = sin (SHIFT_LANES * a->delta);
 }
 
 SHIFT create_shift (int run, int size, double* in, double* out, int rate, double fshift)
@@ -43,6 +55,7 @@ SHIFT create_shift (int run, int size, double* in, double* out, int rate, double
     a->rate = (double)rate;
     a->shift = fshift;
     a->phase = 0.0;
+    init_dotprod ();
     calc_shift (a);
     return a;
 }
@@ -61,24 +74,28 @@ void xshift (SHIFT a)
 {
     if (a->run)
     {
-        int i;
-        double I1, Q1, t1, t2;
+        int i, k;
+        double I1, Q1;
+        double p[2 * SHIFT_LANES];
         double cos_phase = cos (a->phase);
         double sin_phase = sin (a->phase);
-        for (i = 0; i < a->size; i++)
+        // lane k starts at phase + k * delta, so the recursion of nco_block never runs longer than one buffer
+        for (k = 0; k < SHIFT_LANES; k++)
+        {
+            p[2 * k + 0] = cos_phase * a->lane[2 * k + 0] - sin_phase * a->lane[2 * k + 1];
+            p[2 * k + 1] = cos_phase * a->lane[2 * k + 1] + sin_phase * a->lane[2 * k + 0];
+        }
+        i = nco_block (a->out, a->in, a->size, p, a->rot);
+        for (k = 0; i < a->size; i++, k++)
         {
             I1 = a->in[2 * i + 0];
             Q1 = a->in[2 * i + 1];
-            a->out[2 * i + 0] = I1 * cos_phase - Q1 * sin_phase;
-            a->out[2 * i + 1] = I1 * sin_phase + Q1 * cos_phase;
-            t1 = cos_phase;
-            t2 = sin_phase;
-            cos_phase = t1 * a->cos_delta - t2 * a->sin_delta;
-            sin_phase = t1 * a->sin_delta + t2 * a->cos_delta;
-            a->phase += a->delta;
-            if (a->phase >= TWOPI) a->phase -= TWOPI;
-            if (a->phase <   0.0 ) a->phase += TWOPI;
+            a->out[2 * i + 0] = I1 * p[2 * k + 0] - Q1 * p[2 * k + 1];
+            a->out[2 * i + 1] = I1 * p[2 * k + 1] + Q1 * p[2 * k + 0];
         }
+        // one renormalization per buffer: the next one starts from the exact phase
+        a->phase = fmod (a->phase + a->size * a->delta, TWOPI);
+        if (a->phase < 0.0) a->phase += TWOPI;
     }
     else if (a->in != a->out)
         memcpy (a->out, a->in, a->size * sizeof (complex));
@@ -27,6 +27,8 @@ warren@wpratt.com
 #ifndef _shift_h
 #define _shift_h
 
+#define SHIFT_LANES 8           // samples per step of the block NCO
+
 typedef struct _shift
 {
     int run;
@@ -37,8 +39,8 @@ typedef struct _shift
     double shift;
     double phase;
     double delta;
-    double cos_delta;
-    double sin_delta;
+    double lane[2 * SHIFT_LANES];   // exp(j * k * delta), k < SHIFT_LANES
+    double rot[2];                  // exp(j * SHIFT_LANES * delta)
 } shift, *SHIFT;
 
 extern SHIFT create_shift (int run, int size, double* in, double* out, int rate, double fshift);
@@ -67,7 +67,7 @@ SIPHON create_siphon (int run, int position, int mode, int disp, int insize,
     a->idx = 0;
     a->sipout  = (double *) malloc0 (a->sipsize * sizeof (complex));
     a->specout = (double *) malloc0 (a->fftsize * sizeof (complex));
-    a->sipplan = fftw_plan_dft_1d (a->fftsize, (fftw_complex *)a->sipout, (fftw_complex *)a->specout, FFTW_FORWARD, FFTW_PATIENT);
+    a->sipplan = create_fftplan_c2c (a->fftsize, a->sipout, a->specout, FFTW_FORWARD);
     a->window  = (double *) malloc0 (a->fftsize * sizeof (complex));
     InitializeCriticalSectionAndSpinCount(&a->update, 2500);
     build_window (a);
@@ -77,7 +77,7 @@ SIPHON create_siphon (int run, int position, int mode, int disp, int insize,
 void destroy_siphon (SIPHON a)
 {
     DeleteCriticalSection(&a->update);
-    fftw_destroy_plan (a->sipplan);
+    destroy_fftplan (a->sipplan);
     _aligned_free (a->window);
     _aligned_free (a->specout);
     _aligned_free (a->sipout);
@@ -170,7 +170,7 @@ void sip_spectrum (SIPHON a)
         a->sipout[2 * i + 0] *= a->window[i];
         a->sipout[2 * i + 1] *= a->window[i];
     }
-    fftw_execute (a->sipplan);
+    xfftplan (a->sipplan);
 }
 
 /********************************************************************************************************
@@ -46,7 +46,7 @@ typedef struct _siphon
     int fftsize;
     double* specout;
     volatile long specmode;
-    fftw_plan sipplan;
+    FFTPLAN sipplan;
     double* window;
     CRITICAL_SECTION update;
 } siphon, *SIPHON;
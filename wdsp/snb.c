@@ -63,6 +63,17 @@ void calc_snba (SNBA d)
     }
     d->init_oaoutidx = d->oaoutidx;
     d->outaccum = (double *) malloc0 (d->oasize * sizeof (double));
+
+    // scratch for execFrame(), sized for impulses up to xsize samples and prediction orders up to asize
+    d->wrk.xHat_h    = (double *) malloc0 ((d->exec.asize + 1) * sizeof (double));
+    d->wrk.xHat_hr   = (double *) malloc0 ((d->exec.asize + 1) * sizeof (double));
+    d->wrk.xHat_y    = (double *) malloc0 ((d->xsize + 2 * d->exec.asize) * sizeof (double));
+    d->wrk.xHat_e    = (double *) malloc0 ((d->xsize + d->exec.asize) * sizeof (double));
+    d->wrk.xHat_r    = (double *) malloc0 (d->xsize * sizeof (double));
+    d->wrk.xHat_P2   = (double *) malloc0 (d->xsize * sizeof (double));
+    d->wrk.trsolve_w = (double *) malloc0 (2 * d->xsize * sizeof (double));
+    d->wrk.asolve_r  = (double *) malloc0 ((d->exec.asize + 1) * sizeof (double));
+    d->wrk.asolve_z  = (double *) malloc0 ((d->exec.asize + 1) * sizeof (double));
 }
 
 SNBA create_snba (int run, double* in, double* out, int inrate, int internalrate, int bsize, int ovrlp, int xsize,
@@ -101,25 +112,20 @@ SNBA create_snba (int run, double* in, double* out, int inrate, int internalrate
     d->sdet.vp      = (double *) malloc0 (d->xsize * sizeof (double));
     d->sdet.vpwr    = (double *) malloc0 (d->xsize * sizeof (double));
 
-    d->wrk.xHat_a1rows_max = d->xsize + d->exec.asize;
-    d->wrk.xHat_a2cols_max = d->xsize + 2 * d->exec.asize;
-    d->wrk.xHat_r          = (double *) malloc0 (d->xsize * sizeof(double));
-    d->wrk.xHat_ATAI       = (double *) malloc0 (d->xsize * d->xsize * sizeof(double));
-    d->wrk.xHat_A1         = (double *) malloc0 (d->wrk.xHat_a1rows_max * d->xsize * sizeof(double));
-    d->wrk.xHat_A2         = (double *) malloc0 (d->wrk.xHat_a1rows_max * d->wrk.xHat_a2cols_max * sizeof(double));
-    d->wrk.xHat_P1         = (double *) malloc0 (d->xsize * d->wrk.xHat_a2cols_max * sizeof(double));
-    d->wrk.xHat_P2         = (double *) malloc0 (d->xsize * sizeof(double));
-    d->wrk.trI_y           = (double *) malloc0 ((d->xsize - 1) * sizeof(double));
-    d->wrk.trI_v           = (double *) malloc0 ((d->xsize - 1) * sizeof(double));
-    d->wrk.dR_z            = (double *) malloc0 ((d->xsize - 2) * sizeof(double));
-    d->wrk.asolve_r        = (double *) malloc0 ((d->exec.asize + 1) * sizeof(double));
-    d->wrk.asolve_z        = (double *) malloc0 ((d->exec.asize + 1) * sizeof(double));
-
     return d;
 }
 
 void decalc_snba (SNBA d)
 {
+    _aligned_free (d->wrk.asolve_z);
+    _aligned_free (d->wrk.asolve_r);
+    _aligned_free (d->wrk.trsolve_w);
+    _aligned_free (d->wrk.xHat_P2);
+    _aligned_free (d->wrk.xHat_r);
+    _aligned_free (d->wrk.xHat_e);
+    _aligned_free (d->wrk.xHat_y);
+    _aligned_free (d->wrk.xHat_hr);
+    _aligned_free (d->wrk.xHat_h);
     destroy_resample (d->outresamp);
     destroy_resample (d->inresamp);
     _aligned_free (d->outbuff);
@@ -130,18 +136,6 @@ void decalc_snba (SNBA d)
 
 void destroy_snba (SNBA d)
 {
-    _aligned_free (d->wrk.xHat_r);
-    _aligned_free (d->wrk.xHat_ATAI);
-    _aligned_free (d->wrk.xHat_A1);
-    _aligned_free (d->wrk.xHat_A2);
-    _aligned_free (d->wrk.xHat_P1);
-    _aligned_free (d->wrk.xHat_P2);
-    _aligned_free (d->wrk.trI_y);
-    _aligned_free (d->wrk.trI_v);
-    _aligned_free (d->wrk.dR_z);
-    _aligned_free (d->wrk.asolve_r);
-    _aligned_free (d->wrk.asolve_z);
-
     _aligned_free (d->sdet.vpwr);
     _aligned_free (d->sdet.vp);
     _aligned_free (d->exec.unfixed);
@@ -206,119 +200,49 @@ void setSize_snba (SNBA a, int size)
     calc_snba (a);
 }
 
-void ATAc0 (int n, int nr, double* A, double* r)
-{
-    int i, j;
-    memset(r, 0, n * sizeof (double));
-    for (i = 0; i < n; i++)
-        for (j = 0; j < nr; j++)
-            r[i] += A[j * n + i] * A[j * n + 0];
-}
-
-void multA1TA2(double* a1, double* a2, int m, int n, int q, double* c)
-{
-    int i, j, k;
-    int p = q - m;
-    memset (c, 0, m * n * sizeof (double));
-    for (i = 0; i < m; i++)
-    {
-        for (j = 0; j < n; j++)
-        {
-            if (j < p)
-            {
-                for (k = i; k <= min(i + p, j); k++)
-                    c[i * n + j] += a1[k * m + i] * a2[k * n + j];
-            }
-            if (j >= n - p)
-            {
-                for (k = max(i, q - (n - j)); k <= i + p; k++)
-                    c[i * n + j] += a1[k * m + i] * a2[k * n + j];
-            }
-        }
-    }
-}
-
-void multXKE(double* a, double* xk, int m, int q, int p, double* vout)
-{
-    int i, k;
-    memset (vout, 0, m * sizeof (double));
-    for (i = 0; i < m; i++)
-    {
-        for (k = i; k < p; k++)
-            vout[i] += a[i * q + k] * xk[k];
-        for (k = q - p; k <= q - m + i; k++)
-            vout[i] += a[i * q + k] * xk[k];
-    }
-}
-
-void multAv(double* a, double* v, int m, int q, double* vout)
-{
-    int i, k;
-    memset (vout, 0, m * sizeof (double));
-    for (i = 0; i < m; i++)
-    {
-        for (k = 0; k < q; k++)
-            vout[i] += a[i * q + k] * v[k];
-    }
-}
-
+// Least-squares interpolation of the xusize samples following the first asize samples of xk, given the
+// prediction coefficients a[] and the asize known samples on either side of the gap.  The unknown samples x
+// minimize the energy of the prediction error over the span, |A1 x + e|^2, where A1 is the banded convolution
+// matrix of the error filter h = {1, -a[0], ..., -a[asize-1]} and e is the prediction error of the known
+// samples alone (zeros in the gap).  The normal equations A1'A1 x = -A1'e have a symmetric Toeplitz matrix,
+// the autocorrelation of h, with bandwidth asize; they are solved by trsolve() without forming A1.
 void xHat(int xusize, int asize, double* xk, double* a, double* xout,
-    double* r, double* ATAI, double* A1, double* A2, double* P1, double* P2,
-    double* trI_y, double* trI_v, double* dR_z)
-{
-    int i, j, k;
-    int a1rows = xusize + asize;
-    int a2cols = xusize + 2 * asize;
-    memset (r,    0, xusize          * sizeof(double));     // work space
-    memset (ATAI, 0, xusize * xusize * sizeof(double));     // work space
-    memset (A1,   0, a1rows * xusize * sizeof(double));     // work space
-    memset (A2,   0, a1rows * a2cols * sizeof(double));     // work space
-    memset (P1,   0, xusize * a2cols * sizeof(double));     // work space
-    memset (P2,   0, xusize          * sizeof(double));     // work space
-
-    for (i = 0; i < xusize; i++)
-    {
-        A1[i * xusize + i] = 1.0;
-        k = i + 1;
-        for (j = k; j < k + asize; j++)
-            A1[j * xusize + i] = - a[j - k];
-    }
-
+    double* h, double* hr, double* y, double* e, double* r, double* P2, double* trs_w)
+{
+    int i;
+    int ysize = xusize + 2 * asize;
+    int esize = xusize + asize;
+    h[0] = hr[asize] = 1.0;
     for (i = 0; i < asize; i++)
-        {
-            for (k = asize - i - 1, j = 0; k < asize; k++, j++)
-                A2[j * a2cols + i] = a[k];
-        }
-    for (i = asize + xusize; i < 2 * asize + xusize; i++)
-        {
-            A2[(i - asize) * a2cols + i] = - 1.0;
-            for (j = i - asize + 1, k = 0; j < xusize + asize; j++, k++)
-                A2[j * a2cols + i] = a[k];
-        }
-
-    ATAc0(xusize, xusize + asize, A1, r);
-    trI(xusize, r, ATAI, trI_y, trI_v, dR_z);
-    multA1TA2(A1, A2, xusize, 2 * asize + xusize, xusize + asize, P1);
-    multXKE(P1, xk, xusize, xusize + 2 * asize, asize, P2);
-    multAv(ATAI, P2, xusize, xusize, xout);
+        h[i + 1] = hr[asize - 1 - i] = - a[i];
+    memcpy (y, xk, ysize * sizeof (double));
+    memset (y + asize, 0, xusize * sizeof (double));
+    for (i = 0; i < esize; i++)
+        e[i] = dotprod_rr (hr, y + i, asize + 1);
+    for (i = 0; i < xusize; i++)
+        P2[i] = - dotprod_rr (h, e + i, asize + 1);
+    for (i = 0; i < xusize; i++)
+        r[i] = (i <= asize) ? dotprod_rr (h + i, h, asize + 1 - i) : 0.0;
+    trsolve (xusize, asize, r, P2, xout, trs_w);
 }
 
 void invf(int xsize, int asize, double* a, double* x, double* v)
 {
     int i, j;
+    double aj;
     memset (v, 0, xsize * sizeof (double));
-    for (i = asize; i < xsize - asize; i++)
+    for (j = 0; j < asize; j++)
     {
-        for (j = 0; j < asize; j++)
-            v[i] += a[j] * (x[i - 1 - j] + x[i + 1 + j]);
-        v[i] = x[i] - 0.5 * v[i];
+        aj = a[j];
+        for (i = asize; i < xsize - asize; i++)
+            v[i] += aj * (x[i - 1 - j] + x[i + 1 + j]);
+        for (i = xsize - asize; i < xsize; i++)
+            v[i] += aj * x[i - 1 - j];
     }
+    for (i = asize; i < xsize - asize; i++)
+        v[i] = x[i] - 0.5 * v[i];
     for (i = xsize - asize; i < xsize; i++)
-    {
-        for (j = 0; j < asize; j++)
-            v[i] += a[j] * x[i - 1 - j];
         v[i] = x[i] - v[i];
-    }
 }
 
 void det(SNBA d, int asize, double* v, int* detout)
@@ -523,8 +447,8 @@ void execFrame(SNBA d, double* x)
             {
                 asolve(d->xsize, p, x, d->exec.a, d->wrk.asolve_r, d->wrk.asolve_z);
                 xHat(limp[next], p, &x[bimp[next] - p], d->exec.a, d->exec.xHout,
-                    d->wrk.xHat_r, d->wrk.xHat_ATAI, d->wrk.xHat_A1, d->wrk.xHat_A2,
-                    d->wrk.xHat_P1, d->wrk.xHat_P2, d->wrk.trI_y, d->wrk.trI_v, d->wrk.dR_z);
+                    d->wrk.xHat_h, d->wrk.xHat_hr, d->wrk.xHat_y, d->wrk.xHat_e,
+                    d->wrk.xHat_r, d->wrk.xHat_P2, d->wrk.trsolve_w);
                 memcpy (&x[bimp[next]], d->exec.xHout, limp[next] * sizeof (double));
                 memset (&d->exec.unfixed[bimp[next]], 0, limp[next] * sizeof (int));
             }
@@ -604,7 +528,9 @@ PORT void SetRXASNBAovrlp (int channel, int ovrlp)
 PORT void SetRXASNBAasize (int channel, int size)
 {
     EnterCriticalSection (&ch[channel].csDSP);
+    decalc_snba (rxa[channel].snba.p);
     rxa[channel].snba.p->exec.asize = size;
+    calc_snba (rxa[channel].snba.p);
     LeaveCriticalSection (&ch[channel].csDSP);
 }
 
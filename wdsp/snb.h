@@ -86,17 +86,13 @@ typedef struct _snba
     } scan;
     struct _wrk
     {
-        int xHat_a1rows_max;
-        int xHat_a2cols_max;
+        double* xHat_h;
+        double* xHat_hr;
+        double* xHat_y;
+        double* xHat_e;
         double* xHat_r;
-        double* xHat_ATAI;
-        double* xHat_A1;
-        double* xHat_A2;
-        double* xHat_P1;
         double* xHat_P2;
-        double* trI_y;
-        double* trI_v;
-        double* dR_z;
+        double* trsolve_w;
         double* asolve_r;
         double* asolve_z;
     } wrk;
@@ -60,7 +60,7 @@ void calc_varsamp (VARSAMP a)
     a->ncoef += (a->R - 1) * (a->ncoef - 1);
     a->h = fir_bandpass(a->ncoef, fc_norm_low, fc_norm_high, (double)a->R, 1, 0, (double)a->R * a->gain);
     // print_impulse ("imp.txt", a->ncoef, a->h, 0, 0);
-    a->ring = (double *)malloc0(a->rsize * sizeof(complex));
+    a->ring = (double *)malloc0(2 * a->rsize * sizeof(complex));        // mirrored, see xresample()
     a->idx_in = a->rsize - 1;
     a->h_offset = 0.0;
     a->hs = (double *)malloc0 (a->rsize * sizeof (double));
@@ -91,6 +91,7 @@ VARSAMP create_varsamp ( int run, int size, double* in, double* out,
     a->gain = gain;
     a->var = var;
     a->varmode = varmode;
+    init_dotprod ();
     calc_varsamp (a);
     return a;
 }
@@ -103,7 +104,7 @@ void destroy_varsamp (VARSAMP a)
 
 void flush_varsamp (VARSAMP a)
 {
-    memset (a->ring, 0, a->rsize * sizeof (complex));
+    memset (a->ring, 0, 2 * a->rsize * sizeof (complex));
     a->idx_in = a->rsize - 1;
     a->h_offset = 0.0;
     a->isamps = 0.0;
@@ -138,13 +139,14 @@ int xvarsamp (VARSAMP a, double var)
     else            a->dicvar = 0.0;
     if (a->run)
     {
-        int i, j;
-        int idx_out;
+        int i;
+        double* r;
         double I, Q;
         for (i = 0; i < a->size; i++)
         {
-            a->ring[2 * a->idx_in + 0] = a->in[2 * i + 0];
-            a->ring[2 * a->idx_in + 1] = a->in[2 * i + 1];
+            r = a->ring + 2 * a->idx_in;
+            r[0] = r[2 * a->rsize + 0] = a->in[2 * i + 0];
+            r[1] = r[2 * a->rsize + 1] = a->in[2 * i + 1];
             a->inv_cvar += a->dicvar;
             picvar = (uint64_t*)(&a->inv_cvar);
             N = *picvar & 0xffffffffffff0000;
@@ -152,18 +154,11 @@ int xvarsamp (VARSAMP a, double var)
             a->delta = 1.0 - a->inv_cvar;
             while (a->isamps < 1.0)
             {
-                I = 0.0;
-                Q = 0.0;
                 hshift (a);
                 a->h_offset += a->delta;
                 while (a->h_offset >= 1.0) a->h_offset -= 1.0;
                 while (a->h_offset <  0.0) a->h_offset += 1.0;
-                for (j = 0; j < a->rsize; j++)
-                {
-                    if ((idx_out = a->idx_in + j) >= a->rsize) idx_out -= a->rsize;
-                    I += a->hs[j] * a->ring[2 * idx_out + 0];
-                    Q += a->hs[j] * a->ring[2 * idx_out + 1];
-                }
+                dotprod_cr (a->hs, r, a->rsize, &I, &Q);
                 a->out[2 * outsamps + 0] = I;
                 a->out[2 * outsamps + 1] = Q;
                 outsamps++;
@@ -43,7 +43,7 @@ typedef struct _varsamp
     int ncoef;
     double* h;
     int rsize;
-    double* ring;
+    double* ring;       // stored twice
     double var;
     int varmode;
     double cvar;
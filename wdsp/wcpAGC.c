@@ -32,6 +32,58 @@ Santa Cruz, CA  95060
 
 #include "comm.h"
 
+/********************************************************************************************************
+*                                                                                                       *
+*                                       Look-Ahead Peak                                                 *
+*                                                                                                       *
+*   'pk' is a monotonic deque of the abs_ring indices in the window out_index+1 ... in_index whose     *
+*   values are decreasing, i.e., those samples not followed by a larger or equal one.  Its head is     *
+*   the peak of the window, which is what the old rescan of the window produced.                       *
+*                                                                                                       *
+********************************************************************************************************/
+
+static void push_peak (WCPAGC a, int idx)
+{
+    int tail;
+    while (a->pk_count > 0)
+    {
+        if ((tail = a->pk_head + a->pk_count - 1) >= a->ring_buffsize)
+            tail -= a->ring_buffsize;
+        if (a->abs_ring[a->pk[tail]] > a->abs_ring[idx])
+            break;
+        a->pk_count--;
+    }
+    if ((tail = a->pk_head + a->pk_count) >= a->ring_buffsize)
+        tail -= a->ring_buffsize;
+    a->pk[tail] = idx;
+    a->pk_count++;
+}
+
+static void pop_peak (WCPAGC a, int idx)
+{
+    // idx is leaving the window
+    if (a->pk_count > 0 && a->pk[a->pk_head] == idx)
+    {
+        if (++a->pk_head == a->ring_buffsize)
+            a->pk_head = 0;
+        a->pk_count--;
+    }
+}
+
+static void load_peak (WCPAGC a)
+{
+    int j, k;
+    a->pk_head = 0;
+    a->pk_count = 0;
+    k = a->out_index;
+    for (j = 0; j < a->attack_buffsize; j++)
+    {
+        if (++k >= a->ring_buffsize)
+            k -= a->ring_buffsize;
+        push_peak (a, k);
+    }
+}
+
 void calc_wcpagc (WCPAGC a)
 {
     //assign constants
@@ -48,11 +100,13 @@ void calc_wcpagc (WCPAGC a)
     a->state = 0;
     a->ring = (double *)malloc0(RB_SIZE * sizeof(complex));
     a->abs_ring = (double *)malloc0(RB_SIZE * sizeof(double));
+    a->pk = (int *)malloc0(RB_SIZE * sizeof(int));
     loadWcpAGC(a);
 }
 
 void decalc_wcpagc (WCPAGC a)
 {
+    _aligned_free(a->pk);
     _aligned_free(a->abs_ring);
     _aligned_free(a->ring);
 }
@@ -143,6 +197,9 @@ void loadWcpAGC (WCPAGC a)
     a->onemhang_backmult = 1.0 - a->hang_backmult;
 
     a->hang_decay_mult = 1.0 - exp(-1.0 / (a->sample_rate * a->tau_hang_decay));
+
+    // the window may have changed
+    load_peak(a);
 }
 
 void destroy_wcpagc (WCPAGC a)
@@ -156,11 +213,12 @@ void flush_wcpagc (WCPAGC a)
     memset ((void *)a->ring, 0, sizeof(double) * RB_SIZE * 2);
     a->ring_max = 0.0;
     memset ((void *)a->abs_ring, 0, sizeof(double)* RB_SIZE);
+    load_peak (a);
 }
 
 void xwcpagc (WCPAGC a)
 {
-    int i, j, k;
+    int i;
     double mult;
     if (a->run)
     {
@@ -181,6 +239,7 @@ void xwcpagc (WCPAGC a)
             if (++a->in_index >= a->ring_buffsize)
                 a->in_index -= a->ring_buffsize;
 
+            pop_peak (a, a->out_index);
             a->out_sample[0] = a->ring[2 * a->out_index + 0];
             a->out_sample[1] = a->ring[2 * a->out_index + 1];
             a->abs_out_sample = a->abs_ring[a->out_index];
@@ -190,22 +249,13 @@ void xwcpagc (WCPAGC a)
                 a->abs_ring[a->in_index] = max(fabs(a->ring[2 * a->in_index + 0]), fabs(a->ring[2 * a->in_index + 1]));
             else
                 a->abs_ring[a->in_index] = sqrt(a->ring[2 * a->in_index + 0] * a->ring[2 * a->in_index + 0] + a->ring[2 * a->in_index + 1] * a->ring[2 * a->in_index + 1]);
+            push_peak (a, a->in_index);
 
             a->fast_backaverage = a->fast_backmult * a->abs_out_sample + a->onemfast_backmult * a->fast_backaverage;
             a->hang_backaverage = a->hang_backmult * a->abs_out_sample + a->onemhang_backmult * a->hang_backaverage;
 
             if ((a->abs_out_sample >= a->ring_max) && (a->abs_out_sample > 0.0))
-            {
-                a->ring_max = 0.0;
-                k = a->out_index;
-                for (j = 0; j < a->attack_buffsize; j++)
-                {
-                    if (++k == a->ring_buffsize)
-                        k = 0;
-                    if (a->abs_ring[k] > a->ring_max)
-                        a->ring_max = a->abs_ring[k];
-                }
-            }
+                a->ring_max = a->abs_ring[a->pk[a->pk_head]];
             if (a->abs_ring[a->in_index] > a->ring_max)
                 a->ring_max = a->abs_ring[a->in_index];
 
@@ -68,6 +68,9 @@ typedef struct _wcpagc
     double* abs_ring;
     int ring_buffsize;
     double ring_max;
+    int* pk;                    // look-ahead peak: monotonic deque of abs_ring indices
+    int pk_head;
+    int pk_count;
 
     double attack_mult;
     double decay_mult;
@@ -171,6 +171,7 @@ extern void XCreateAnalyzer(    int disp,
                         char *app_data_path
                         );
 extern void DestroyAnalyzer(int disp);
+extern void GetDisplayLatency(int disp, double *avg_usec, double *max_usec, int reset);
 extern void GetPixels   (   int disp,
                     int pixout,
                     dOUTREAL *pix,
@@ -580,6 +581,8 @@ extern void SetTXAPHROTReverse (int channel, int reverse);
 //
 
 extern void fexchange0 (int channel, double* in, double* out, int* error);
+extern double* fexchange_acquire (int channel);
+extern void fexchange_commit (int channel, double* out, int* error);
 extern void fexchange2 (int channel, INREAL *Iin, INREAL *Qin, OUTREAL *Iout, OUTREAL *Qout, int* error);
 
 //
@@ -597,7 +600,9 @@ extern void SetTXAiqcEnd (int channel);
 //
 
 extern double GetRXAMeter (int channel, int mt);
+extern void GetRXAMeters (int channel, double* all);
 extern double GetTXAMeter (int channel, int mt);
+extern void GetTXAMeters (int channel, double* all);
 
 //
 // Interfaces from nbp.c
@@ -916,3 +921,20 @@ extern  void SetTXALevelerTop (int channel, double maxgain);
 
 extern char* wisdom_get_status();
 extern void WDSPwisdom (char* directory);
+
+//
+// Interfaces from linux_port.c
+// policy is SCHED_OTHER, SCHED_FIFO or SCHED_RR, cpus a bit mask of
+// allowed CPUs (0: no restriction). Applies to threads started later.
+//
+
+extern void WDSPSetThreadPolicy (int policy, int priority, unsigned int cpus);
+
+//
+// Statistics of the worker pool used by the spectrum analyzer:
+// number of threads, current and maximum queue depth, work items
+// submitted, completed, stolen by another worker and executed by
+// the caller because all queues were full, and execution time.
+//
+extern void WDSPGetWorkerStats (int *threads, int *depth, int *max_depth, long long *submitted,
+    long long *completed, long long *stolen, long long *inlined, double *avg_usec, double *max_usec);